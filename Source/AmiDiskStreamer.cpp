@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    AmiDiskStreamer.cpp
+    Created: 18 Oct 2026 4:31:09pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiDiskStreamer.h"
+
+AmiDiskStreamer::AmiDiskStreamer() {}
+
+AmiDiskStreamer::~AmiDiskStreamer()
+{
+    thread.removeTimeSliceClient(this);
+    thread.stopThread(1000);
+}
+
+void AmiDiskStreamer::addStream(AmiSampleStream* stream)
+{
+    if (stream == nullptr) return;
+
+    // the rings and the thread only exist once something is streamed
+    if (ringStorage == nullptr)
+    {
+        ringStorage.calloc((size_t) (AmiVoiceBank::maxVoices * 2 * ringSize));
+        ringData.store(ringStorage.get(), std::memory_order_release);
+
+        thread.addTimeSliceClient(this);
+        thread.startThread();
+    }
+
+    const juce::ScopedLock sl(streamLock);
+    streams.addIfNotAlreadyThere(stream);
+}
+
+void AmiDiskStreamer::attach(const int lane, const AmiSampleStream* stream)
+{
+    Ring_t& ring = rings[lane];
+
+    const uint64_t generation = (ring.window.load(std::memory_order_relaxed) >> 32) + 1;
+    const int base = stream != nullptr ? stream->getHeadLength() : 0;
+
+    ring.stream.store(stream, std::memory_order_relaxed);
+    ring.base.store(base, std::memory_order_relaxed);
+    ring.readFrom.store(0, std::memory_order_relaxed);
+
+    ring.window.store((generation << 32) | (uint32_t) base, std::memory_order_release);
+}
+
+void AmiDiskStreamer::getWindow(const int lane, const int readFrom, int& start, int& end)
+{
+    Ring_t& ring = rings[lane];
+
+    ring.readFrom.store(readFrom, std::memory_order_release);
+
+    end = (int) (uint32_t) ring.window.load(std::memory_order_acquire);
+
+    // anything older than one ring back, or below what we just promised to read, may be overwritten
+    start = juce::jmax(ring.base.load(std::memory_order_relaxed), end - ringSize, readFrom);
+}
+
+int AmiDiskStreamer::useTimeSlice()
+{
+    {
+        const juce::ScopedLock sl(streamLock);
+
+        // a stream only we hold has no sound left and so no voice playing it
+        for (int i = streams.size(); --i >= 0;)
+            if (streams.getObjectPointerUnchecked(i)->getReferenceCount() == 1)
+                streams.remove(i);
+    }
+
+    bool busy = false;
+
+    for (int lane = 0; lane < AmiVoiceBank::maxVoices; lane++)
+        busy = fillRing(lane) || busy;
+
+    return busy ? 0 : 5;
+}
+
+bool AmiDiskStreamer::fillRing(const int lane)
+{
+    constexpr int blockSize = 8192;
+
+    Ring_t& ring = rings[lane];
+
+    uint64_t window = ring.window.load(std::memory_order_acquire);
+    const AmiSampleStream* attached = ring.stream.load(std::memory_order_relaxed);
+
+    if (attached == nullptr) return false;
+
+    AmiSampleStream::Ptr stream;
+
+    {
+        // only read from streams we still hold, never through the lane's raw pointer
+        const juce::ScopedLock sl(streamLock);
+
+        for (AmiSampleStream* s : streams)
+            if (s == attached) stream = s;
+    }
+
+    if (stream == nullptr) return false;
+
+    const int readFrom = ring.readFrom.load(std::memory_order_acquire);
+    const int target = juce::jmin(stream->getLength(), readFrom + ringSize);
+
+    // a voice that has already moved past what we hold (a glide onto a new sound)
+    // skips ahead rather than having everything behind it read first
+    const int end = juce::jmax((int) (uint32_t) window, readFrom);
+
+    if (end >= target) return false;
+
+    const int numSamples = juce::jmin(blockSize, target - end);
+
+    int8_t* data = ringData.load(std::memory_order_acquire) + lane * 2 * ringSize;
+    int8_t* dest[2] = { data, data + ringSize };
+
+    if (!stream->readAhead(dest, ringSize - 1, end, numSamples)) return false;
+
+    // fails if the lane was re-attached meanwhile, dropping what we just read
+    ring.window.compare_exchange_strong(window, (window & 0xffffffff00000000ull) | (uint32_t) (end + numSamples),
+                                        std::memory_order_release);
+
+    return true;
+}
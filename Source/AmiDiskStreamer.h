@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    AmiDiskStreamer.h
+    Created: 18 Oct 2026 4:31:09pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AmiVoiceBank.h"
+#include "AmiSampleStream.h"
+
+/*
+  ==============================================================================
+
+
+  //// Read-ahead for direct-from-disk samples ////
+
+  Every lane of the voice bank gets a ring of 8-bit samples. A voice playing a
+  streamed sample attaches its lane to the stream when the note starts, and
+  before each chunk tells the streamer how far back it may still read. A
+  background thread keeps each attached ring filled up to one ring's length
+  ahead of that, starting right after the stream's head.
+
+  A ring's window is published as one atomic word of (generation, end), so
+  that a block read for a note that has since been replaced can never be
+  published for the new one. The render thread never waits: any position it
+  needs that is neither resident nor in its ring plays as silence and is
+  counted as an underrun.
+
+  ==============================================================================
+*/
+
+class AmiDiskStreamer : private juce::TimeSliceClient
+{
+public:
+
+    AmiDiskStreamer();
+    ~AmiDiskStreamer() override;
+
+    static constexpr int ringSize = AmiVoiceBank::streamRingSize;
+
+    /** Message thread: keeps a stream alive for the read-ahead thread until no
+        sound uses it any more. Call this before the stream's sound is published.
+    */
+    void addStream(AmiSampleStream* stream);
+
+    //==============================================================================
+    /** Render thread: points the lane at a stream, its ring empty and starting
+        after the head. Pass nullptr to detach it.
+    */
+    void attach(const int lane, const AmiSampleStream* stream);
+
+    /** Render thread: publishes the lowest position the lane may read in its
+        next chunk, and returns the range of positions its ring now holds.
+    */
+    void getWindow(const int lane, const int readFrom, int& start, int& end);
+
+    const int8_t* getRing(const int lane, const int channel) const noexcept
+    {
+        int8_t* data = ringData.load(std::memory_order_acquire);
+        return data != nullptr ? data + (lane * 2 + channel) * ringSize : nullptr;
+    }
+
+    void reportUnderruns(const int numMissed) { underruns.fetch_add(numMissed, std::memory_order_relaxed); }
+
+    /** Samples the render thread has found missing since the last call. */
+    int takeUnderruns() { return underruns.exchange(0); }
+
+private:
+
+    int useTimeSlice() override;
+    bool fillRing(const int lane);
+
+    typedef struct Ring_t
+    {
+    public:
+
+        std::atomic<const AmiSampleStream*> stream { nullptr };
+
+        // generation in the high 32 bits, one past the last position held in the low 32
+        std::atomic<uint64_t> window { 0 };
+        std::atomic<int> base { 0 }, readFrom { 0 };
+
+    } Ring_t;
+
+    Ring_t rings[AmiVoiceBank::maxVoices];
+
+    juce::HeapBlock<int8_t> ringStorage;
+    std::atomic<int8_t*> ringData { nullptr };
+
+    juce::CriticalSection streamLock;
+    juce::ReferenceCountedArray<AmiSampleStream> streams;
+
+    std::atomic<int> underruns { 0 };
+
+    juce::TimeSliceThread thread { "Ami disk read-ahead" };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiDiskStreamer)
+};
@@ -0,0 +1,198 @@
+/*
+  ==============================================================================
+
+    AmiMidiDispatcher.cpp
+    Created: 17 Oct 2026 3:40:12pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiMidiDispatcher.h"
+#include "AmiSynthesiser.h"
+
+AmiMidiDispatcher::AmiMidiDispatcher()
+{
+    std::memset(noteRoutes, 0, sizeof(noteRoutes));
+    std::memset(channelRoutes, 0, sizeof(channelRoutes));
+}
+
+AmiMidiDispatcher::~AmiMidiDispatcher() {}
+
+void AmiMidiDispatcher::prepare(const int expectedEventsPerBlock)
+{
+    events.ensureStorageAllocated(expectedEventsPerBlock);
+    modWheelEvents.ensureStorageAllocated(expectedEventsPerBlock);
+}
+
+void AmiMidiDispatcher::updateRouting(const int numSlots, const std::atomic<int>* midiChannel,
+                                      const std::atomic<int>* lowNote, const std::atomic<int>* highNote)
+{
+    if (!routingDirty.exchange(false)) return;
+
+    jassert(numSlots <= maxSlots);
+
+    std::memset(noteRoutes, 0, sizeof(noteRoutes));
+    std::memset(channelRoutes, 0, sizeof(channelRoutes));
+
+    for (int n = 0; n < juce::jmin(numSlots, maxSlots); n++)
+    {
+        const uint16_t slotBit = (uint16_t) (1 << n);
+
+        const int channel = midiChannel[n];
+        const int low  = juce::jlimit(0, 127, lowNote[n].load());
+        const int high = juce::jlimit(0, 127, highNote[n].load());
+
+        for (int ch = 0; ch < 16; ch++)
+        {
+            if (channel > 0 && channel != ch + 1) continue;
+
+            channelRoutes[ch] |= slotBit;
+
+            for (int key = low; key <= high; key++)
+                noteRoutes[ch][key] |= slotBit;
+        }
+    }
+}
+
+void AmiMidiDispatcher::parseBlock(const juce::MidiBuffer& midi, const int startSample, const int endSample)
+{
+    events.clearQuick();
+    modWheelEvents.clearQuick();
+
+    slotsWithEvents = 0;
+
+    for (auto it = midi.findNextSamplePosition(startSample); it != midi.cend(); ++it)
+    {
+        const auto metadata = *it;
+
+        if (metadata.samplePosition >= endSample) break;
+        if (metadata.numBytes < 2) continue;
+
+        Event_t event;
+
+        event.samplePosition = metadata.samplePosition - startSample;
+        event.status = metadata.data[0];
+        event.data1  = metadata.data[1] & 0x7f;
+        event.data2  = metadata.numBytes > 2 ? metadata.data[2] & 0x7f : 0;
+
+        const int channel = event.status & 0x0f;
+
+        switch (event.status & 0xf0)
+        {
+            case 0x80:
+            case 0x90:
+                event.slotMask = noteRoutes[channel][event.data1];
+                break;
+
+            case 0xb0:
+                if (event.data1 == 0x01)
+                {
+                    modWheelEvents.add({ event.samplePosition, event.data2 });
+                    continue;
+                }
+
+                // only sustain, sostenuto and all-notes/sound-off reach the voices,
+                // so other controllers shouldn't split anyone's render
+                if (event.data1 != 0x40 && event.data1 != 0x42 &&
+                    event.data1 != 0x78 && event.data1 != 0x7b) continue;
+
+                event.slotMask = channelRoutes[channel];
+                break;
+
+            case 0xe0:
+                event.slotMask = channelRoutes[channel];
+                break;
+
+            default:
+                continue;
+        }
+
+        if (event.slotMask == 0) continue;
+
+        slotsWithEvents |= event.slotMask;
+        events.add(event);
+    }
+}
+
+void AmiMidiDispatcher::renderSlots(AmiSynthesiser* slots, const int numSlots, juce::AudioBuffer<float>& buffer, const int numSamples)
+{
+    for (int n = 0; n < juce::jmin(numSlots, maxSlots); n++)
+    {
+        if ((slotsWithEvents & (1 << n)) == 0)
+            slots[n].renderSubBlock(buffer, 0, numSamples);
+        else
+            renderSlot(slots[n], n, buffer, numSamples);
+    }
+}
+
+void AmiMidiDispatcher::renderSlot(AmiSynthesiser& slot, const int slotNumber, juce::AudioBuffer<float>& buffer, const int numSamples)
+{
+    const uint16_t slotBit = (uint16_t) (1 << slotNumber);
+
+    int startSample = 0, samplesLeft = numSamples;
+
+    for (const Event_t& event : events)
+    {
+        if ((event.slotMask & slotBit) == 0) continue;
+
+        const int samplesToNextEvent = event.samplePosition - startSample;
+
+        if (samplesToNextEvent >= samplesLeft)
+        {
+            // events past the end of the block are handled once the rest is rendered
+            if (samplesLeft > 0) slot.renderSubBlock(buffer, startSample, samplesLeft);
+
+            startSample += samplesLeft;
+            samplesLeft = 0;
+        }
+        else if (samplesToNextEvent > 0)
+        {
+            slot.renderSubBlock(buffer, startSample, samplesToNextEvent);
+
+            startSample += samplesToNextEvent;
+            samplesLeft -= samplesToNextEvent;
+        }
+
+        dispatch(slot, event);
+    }
+
+    if (samplesLeft > 0) slot.renderSubBlock(buffer, startSample, samplesLeft);
+}
+
+void AmiMidiDispatcher::dispatch(AmiSynthesiser& slot, const Event_t& event)
+{
+    const int channel = (event.status & 0x0f) + 1;
+
+    switch (event.status & 0xf0)
+    {
+        case 0x90:
+            if (event.data2 > 0)
+            {
+                slot.noteOn(channel, event.data1, event.data2 * (1.0f / 127.0f));
+                break;
+            }
+
+            slot.noteOff(channel, event.data1, 0.0f, true);
+            break;
+
+        case 0x80:
+            slot.noteOff(channel, event.data1, event.data2 * (1.0f / 127.0f), true);
+            break;
+
+        case 0xb0:
+            if (event.data1 == 0x78 || event.data1 == 0x7b)
+                slot.allNotesOff(channel, true);
+            else
+                slot.handleController(channel, event.data1, event.data2);
+            break;
+
+        case 0xe0:
+            slot.handlePitchWheel(channel, event.data1 | (event.data2 << 7));
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    AmiMidiDispatcher.h
+    Created: 17 Oct 2026 3:40:12pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class AmiSynthesiser;
+
+/*
+  ==============================================================================
+
+
+  //// Single-pass MIDI routing for the sampler slots ////
+
+  The block's MIDI is decoded once into a flat event list, each event tagged
+  with a bitmask of the slots it is meant for. Note events are routed through a 16 channel x 128 key table built from every slot's MIDI
+  channel and key range; channel-wide events go to every slot listening on
+  that channel.
+
+  Each slot then renders its block split only at its own events, at their
+  exact sample offsets rather than juce::Synthesiser's 32-sample minimum
+  sub-block, so a pitch bend lands on the sample it was sent for. The voices
+  have no aftertouch response, so neither kind of aftertouch is routed.
+
+  The mod wheel isn't a slot event: it drives the shared vibrato depth, so its
+  values are queued with their sample offsets for the vibrato render instead.
+
+  ==============================================================================
+*/
+
+class AmiMidiDispatcher
+{
+public:
+
+    AmiMidiDispatcher();
+    ~AmiMidiDispatcher();
+
+    static constexpr int maxSlots = 16;
+
+    /** Reserves room for the events of a typical block so parsing doesn't allocate. */
+    void prepare(const int expectedEventsPerBlock);
+
+    /** Marks the routing table as stale. Safe to call from any thread. */
+    void invalidateRouting() { routingDirty = true; }
+
+    /** Rebuilds the routing table if it is stale, from each slot's MIDI channel
+        (<= 0 for omni) and key range.
+    */
+    void updateRouting(const int numSlots, const std::atomic<int>* midiChannel,
+                       const std::atomic<int>* lowNote, const std::atomic<int>* highNote);
+
+    /** Decodes the MIDI from startSample up to (not including) endSample into
+        slot events and mod wheel changes, timed from startSample.
+    */
+    void parseBlock(const juce::MidiBuffer& midi, const int startSample, const int endSample);
+
+    /** Renders every slot into buffer, each split only at its own events from parseBlock(). */
+    void renderSlots(AmiSynthesiser* slots, const int numSlots, juce::AudioBuffer<float>& buffer, const int numSamples);
+
+    typedef struct ModEvent_t
+    {
+    public:
+
+        int samplePosition, value;
+
+    } ModEvent_t;
+
+    /** Mod wheel (CC1) values from the last parseBlock(), in sample order, on any channel. */
+    const juce::Array<ModEvent_t>& getModWheelEvents() const { return modWheelEvents; }
+
+private:
+
+    typedef struct Event_t
+    {
+    public:
+
+        int samplePosition;
+        uint16_t slotMask;
+        uint8_t status, data1, data2;
+
+    } Event_t;
+
+    void renderSlot(AmiSynthesiser& slot, const int slotNumber, juce::AudioBuffer<float>& buffer, const int numSamples);
+    static void dispatch(AmiSynthesiser& slot, const Event_t& event);
+
+    juce::Array<Event_t> events;
+    juce::Array<ModEvent_t> modWheelEvents;
+    uint16_t slotsWithEvents = 0;
+
+    uint16_t noteRoutes[16][128];
+    uint16_t channelRoutes[16];
+
+    std::atomic<bool> routingDirty { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiMidiDispatcher)
+};
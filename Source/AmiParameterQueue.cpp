@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    AmiParameterQueue.cpp
+    Created: 17 Oct 2026 5:02:48pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiParameterQueue.h"
+
+AmiParameterQueue::AmiParameterQueue() {}
+
+AmiParameterQueue::~AmiParameterQueue() {}
+
+bool AmiParameterQueue::push(juce::RangedAudioParameter* param, const float value)
+{
+    int start1, size1, start2, size2;
+
+    if (param == nullptr) return false;
+
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1) return false;
+
+    updates[size1 > 0 ? start1 : start2] = { param, value };
+    fifo.finishedWrite(1);
+
+    return true;
+}
+
+void AmiParameterQueue::flush()
+{
+    int start1, size1, start2, size2;
+
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    const int numRead = size1 + size2;
+
+    for (int i = 0; i < numRead; i++)
+    {
+        const Update_t& update = updates[i < size1 ? start1 + i : start2 + (i - size1)];
+
+        update.param->beginChangeGesture();
+        update.param->setValueNotifyingHost(update.param->convertTo0to1(update.value));
+        update.param->endChangeGesture();
+    }
+
+    fifo.finishedRead(numRead);
+}
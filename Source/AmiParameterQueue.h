@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    AmiParameterQueue.h
+    Created: 17 Oct 2026 5:02:48pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Audio thread to message thread parameter feedback ////
+
+  A single-producer, single-consumer queue of parameter values. The audio
+  thread pushes without locking or allocating, and the message thread later
+  applies each update as a full host-notifying change gesture, which is what
+  runs the APVTS listeners and updates the GUI.
+
+  ==============================================================================
+*/
+
+class AmiParameterQueue
+{
+public:
+
+    AmiParameterQueue();
+    ~AmiParameterQueue();
+
+    static constexpr int capacity = 256;
+
+    /** Queues a new (unnormalised) value for the parameter. Wait-free; call it
+        from the audio thread only. Returns false, dropping the update, if the
+        message thread has fallen a whole queue behind.
+    */
+    bool push(juce::RangedAudioParameter* param, const float value);
+
+    /** Applies everything queued so far. Call it from the message thread only. */
+    void flush();
+
+private:
+
+    typedef struct Update_t
+    {
+    public:
+
+        juce::RangedAudioParameter* param;
+        float value;
+
+    } Update_t;
+
+    juce::AbstractFifo fifo { capacity };
+    Update_t updates[capacity];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiParameterQueue)
+};
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    AmiResampler.cpp
+    Created: 18 Oct 2026 2:26:51pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiResampler.h"
+
+juce::AudioBuffer<float> AmiResampler::process(const juce::AudioBuffer<float>& source, const double ratio,
+                                               const int newLength, const Quality quality, AmiSampleLoader& workers)
+{
+    const int numChannels = juce::jmax(1, source.getNumChannels()), inLength = source.getNumSamples();
+
+    juce::AudioBuffer<float> result(numChannels, juce::jmax(0, newLength));
+    result.clear();
+
+    if (newLength <= 0 || inLength <= 0 || ratio <= 0.0) return result;
+
+    if (quality == qualityNearest)
+    {
+        for (int chan = 0; chan < source.getNumChannels(); chan++)
+        {
+            const float* in = source.getReadPointer(chan);
+            float* out = result.getWritePointer(chan);
+
+            for (int i = 0; i < newLength; i++)
+                out[i] = in[juce::jmin(inLength - 1, (int) std::floor((double) i * ratio))];
+        }
+
+        return result;
+    }
+
+    Kernel_t kernel;
+    buildKernel(kernel, ratio, quality);
+
+    const int numChunks = (newLength + chunkSize - 1) / chunkSize;
+
+    // chunks write disjoint ranges of the output, so they need no locking
+    workers.runParallel(numChunks * source.getNumChannels(), [&](const int item)
+    {
+        const int chan = item / numChunks, start = (item % numChunks) * chunkSize;
+
+        processChunk(kernel, source.getReadPointer(chan), inLength, result.getWritePointer(chan),
+                     start, juce::jmin(newLength, start + chunkSize), ratio);
+    });
+
+    return result;
+}
+
+void AmiResampler::buildKernel(Kernel_t& kernel, const double ratio, const Quality quality)
+{
+    constexpr double pi = juce::MathConstants<double>::pi;
+
+    // zero crossings either side of the centre, measured at the output rate
+    static const int zeroCrossings[numQualities] = { 0, 4, 8, 16 };
+    static const int phases[numQualities]        = { 0, 64, 256, 512 };
+
+    // just under the lower of the two Nyquists, leaving room for the transition band
+    const double cutoff = 0.95 * juce::jmin(1.0, 1.0 / ratio);
+    const double halfWidth = std::ceil((double) zeroCrossings[quality] / cutoff);
+
+    kernel.numTaps   = 2 * (int) halfWidth;
+    kernel.numPhases = phases[quality];
+    kernel.coeffs.allocate((size_t) ((kernel.numPhases + 1) * kernel.numTaps), true);
+
+    for (int p = 0; p <= kernel.numPhases; p++)
+    {
+        const double frac = (double) p / kernel.numPhases;
+        float* row = kernel.coeffs + p * kernel.numTaps;
+        double sum = 0.0;
+
+        for (int t = 0; t < kernel.numTaps; t++)
+        {
+            // distance of tap t (sample idx - (halfWidth - 1) + t) from the read position
+            const double x = (double) (t - (kernel.numTaps / 2 - 1)) - frac;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+            const double window = std::abs(x) >= halfWidth ? 0.0
+                                : 0.42 + 0.5 * std::cos(pi * x / halfWidth) + 0.08 * std::cos(2.0 * pi * x / halfWidth);
+
+            row[t] = (float) (sinc * window);
+            sum += row[t];
+        }
+
+        // unity gain at DC for every phase
+        for (int t = 0; t < kernel.numTaps; t++)
+            row[t] = (float) (row[t] / sum);
+    }
+}
+
+void AmiResampler::processChunk(const Kernel_t& kernel, const float* in, const int inLength,
+                                float* out, const int start, const int end, const double ratio)
+{
+    const int numTaps = kernel.numTaps, halfTaps = numTaps / 2;
+
+    juce::HeapBlock<float> taps((size_t) numTaps);
+
+    for (int i = start; i < end; i++)
+    {
+        const double srcPos = (double) i * ratio;
+        const int idx = (int) srcPos;
+
+        const double phase = (srcPos - idx) * kernel.numPhases;
+        const int p = juce::jmin(kernel.numPhases - 1, (int) phase);
+        const float blend = (float) (phase - p);
+
+        const float* c0 = kernel.coeffs + p * numTaps;
+        const float* c1 = c0 + numTaps;
+
+        const int first = idx - (halfTaps - 1);
+
+        // taps past either end of the sample read as silence
+        if (first >= 0 && first + numTaps <= inLength)
+        {
+            for (int t = 0; t < numTaps; t++)
+                taps[t] = in[first + t];
+        }
+        else
+        {
+            for (int t = 0; t < numTaps; t++)
+                taps[t] = (first + t >= 0 && first + t < inLength) ? in[first + t] : 0.f;
+        }
+
+        float sum0 = 0.f, sum1 = 0.f;
+
+        for (int t = 0; t < numTaps; t++)
+        {
+            sum0 += taps[t] * c0[t];
+            sum1 += taps[t] * c1[t];
+        }
+
+        out[i] = sum0 + (sum1 - sum0) * blend;
+    }
+}
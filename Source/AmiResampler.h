@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    AmiResampler.h
+    Created: 18 Oct 2026 2:26:51pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AmiSampleLoader.h"
+
+/*
+  ==============================================================================
+
+
+  //// Offline sample rate conversion ////
+
+  Band-limited resampling for the editor's resample button. Each output
+  sample is a windowed-sinc FIR over the source, with the kernel taken from a
+  polyphase table built once per conversion. When shrinking the rate the
+  cutoff drops to the new Nyquist and the kernel widens to match, so nothing
+  above it folds back into the sample.
+
+  The output is cut into chunks that are filled independently on the sample
+  loader's pool, so a long sample converts in a few milliseconds rather than
+  holding up the message thread.
+
+  ==============================================================================
+*/
+
+class AmiResampler
+{
+public:
+
+    enum Quality
+    {
+        /** Picks the nearest source sample: the old tracker-style aliasing. */
+        qualityNearest = 0,
+        qualityDraft,
+        qualityNormal,
+        qualityHigh,
+
+        numQualities
+    };
+
+    /** Converts every channel of source to newLength samples, stepping
+        ratio (source rate / new rate) source samples per output sample.
+    */
+    static juce::AudioBuffer<float> process(const juce::AudioBuffer<float>& source, const double ratio,
+                                            const int newLength, const Quality quality, AmiSampleLoader& workers);
+
+private:
+
+    AmiResampler() = delete;
+
+    typedef struct Kernel_t
+    {
+    public:
+
+        int numTaps = 0, numPhases = 0;
+
+        /** numPhases + 1 rows of numTaps, so a phase can blend with the next one. */
+        juce::HeapBlock<float> coeffs;
+
+    } Kernel_t;
+
+    static void buildKernel(Kernel_t& kernel, const double ratio, const Quality quality);
+
+    static void processChunk(const Kernel_t& kernel, const float* in, const int inLength,
+                             float* out, const int start, const int end, const double ratio);
+
+    static constexpr int chunkSize = 16384;
+};
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    AmiSampleBlock.cpp
+    Created: 19 Oct 2026 11:26:50am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSampleBlock.h"
+
+AmiSampleBlock::AmiSampleBlock() {}
+
+AmiSampleBlock::~AmiSampleBlock() {}
+
+void AmiSampleBlock::allocate(const int* lengths, const int numRuns)
+{
+    const auto roundUp = [](const size_t n) { return (n + guardLength - 1) / guardLength * guardLength; };
+
+    offsets.resize((size_t) numRuns);
+
+    size_t total = guardLength;
+
+    for (int n = 0; n < numRuns; n++)
+    {
+        jassert(lengths[n] >= 0);
+
+        offsets[(size_t) n] = total;
+        total += roundUp((size_t) lengths[n]) + guardLength;
+    }
+
+    // calloc: every guard starts out silent, and one guard's worth of slack to align the first run
+    storage.calloc(total + guardLength);
+
+    const size_t misalignment = (size_t) reinterpret_cast<uintptr_t>(storage.get()) % guardLength;
+    base = storage.get() + (misalignment > 0 ? guardLength - misalignment : 0);
+}
+
+void AmiSampleBlock::allocate(const int length, const int numRuns)
+{
+    std::vector<int> lengths((size_t) numRuns, length);
+
+    allocate(lengths.data(), numRuns);
+}
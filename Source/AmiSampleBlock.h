@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    AmiSampleBlock.h
+    Created: 19 Oct 2026 11:26:50am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Guarded 8-bit sample memory ////
+
+  The quantized samples the voice kernel reads. A block holds one or more runs
+  (a channel, or a channel's pyramid level), each starting on a guardLength
+  boundary and with guardLength samples either side of it, so the interpolators
+  can read taps past either end without clamping them.
+
+  The guards read as silence unless the owner writes something else into the
+  one after a run, such as where a loop carries on from.
+
+  ==============================================================================
+*/
+
+class AmiSampleBlock
+{
+public:
+
+    static constexpr int guardLength = 64;   // samples either side of a run, and the alignment of each one
+
+    AmiSampleBlock();
+    ~AmiSampleBlock();
+
+    /** Lays out one silent run for each of the given lengths, dropping any earlier ones. */
+    void allocate(const int* lengths, const int numRuns);
+
+    /** The same, for numRuns runs of one length. */
+    void allocate(const int length, const int numRuns);
+
+    int getNumRuns() const noexcept { return (int) offsets.size(); }
+
+    /** The first sample of a run; index -guardLength up to length + guardLength - 1 may be read. */
+    int8_t* getRun(const int run) const noexcept
+    {
+        jassert(run >= 0 && run < getNumRuns());
+        return base + offsets[(size_t) run];
+    }
+
+private:
+
+    juce::HeapBlock<int8_t> storage;
+    int8_t* base = nullptr;
+
+    std::vector<size_t> offsets;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSampleBlock)
+};
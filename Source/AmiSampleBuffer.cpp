@@ -0,0 +1,29 @@
+/*
+  ==============================================================================
+
+    AmiSampleBuffer.cpp
+    Created: 18 Oct 2026 9:41:12am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSampleBuffer.h"
+
+AmiSampleBuffer::AmiSampleBuffer(juce::AudioBuffer<float>&& samples)
+    : buffer(std::move(samples)), length(buffer.getNumSamples()), stride(1), overview(false) {}
+
+AmiSampleBuffer::AmiSampleBuffer(juce::AudioBuffer<float>&& samples, const int sampleLength, const int sampleStride)
+    : buffer(std::move(samples)), length(sampleLength), stride(sampleStride), overview(true)
+{
+    jassert(stride > 0 && buffer.getNumSamples() * stride >= length);
+}
+
+AmiSampleBuffer::~AmiSampleBuffer() {}
+
+const juce::AudioBuffer<float>& AmiSampleBuffer::getEmptyBuffer()
+{
+    static const juce::AudioBuffer<float> empty(1, 0);
+    return empty;
+}
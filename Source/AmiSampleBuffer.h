@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    AmiSampleBuffer.h
+    Created: 18 Oct 2026 9:41:12am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Shared sample storage ////
+
+  A slot's float samples, decoded once and never modified afterwards. The
+  processor, the slot's sound, the editor's waveform view and the state
+  serializer all hold references to the same buffer, so a sample exists in
+  memory once however many of them are looking at it. Changing a slot's
+  samples means building a new buffer and swapping the reference.
+
+  ==============================================================================
+*/
+
+class AmiSampleBuffer : public juce::ReferenceCountedObject
+{
+public:
+
+    typedef juce::ReferenceCountedObjectPtr<AmiSampleBuffer> Ptr;
+
+    /** Takes over the samples without copying them. */
+    explicit AmiSampleBuffer(juce::AudioBuffer<float>&& samples);
+
+    /** Takes over an overview of a streamed sample of the given length, holding
+        one sample (the one furthest from zero) for every stride of the original.
+    */
+    AmiSampleBuffer(juce::AudioBuffer<float>&& overview, const int length, const int stride);
+
+    ~AmiSampleBuffer() override;
+
+    const juce::AudioBuffer<float>& getBuffer() const noexcept { return buffer; }
+
+    int getNumSamples() const noexcept  { return buffer.getNumSamples(); }
+    int getNumChannels() const noexcept { return buffer.getNumChannels(); }
+
+    const float* getReadPointer(const int channel) const noexcept { return buffer.getReadPointer(channel); }
+
+    /** The length of the sample this stands for, which an overview doesn't hold in full. */
+    int getLength() const noexcept { return length; }
+    int getStride() const noexcept { return stride; }
+    bool isOverview() const noexcept { return overview; }
+
+    /** The buffer a slot with no samples reads as. */
+    static const juce::AudioBuffer<float>& getEmptyBuffer();
+
+    /** The samples of a possibly null buffer. */
+    static const juce::AudioBuffer<float>& getBufferOf(const AmiSampleBuffer* b)
+    {
+        return b != nullptr ? b->getBuffer() : getEmptyBuffer();
+    }
+
+private:
+
+    const juce::AudioBuffer<float> buffer;
+
+    const int length, stride;
+    const bool overview;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSampleBuffer)
+};
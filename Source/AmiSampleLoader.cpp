@@ -0,0 +1,290 @@
+/*
+  ==============================================================================
+
+    AmiSampleLoader.cpp
+    Created: 17 Oct 2026 7:34:05pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSampleLoader.h"
+#include "AmiSamplerSound.h"
+
+//==============================================================================
+class AmiSampleLoader::LoadJob : public juce::ThreadPoolJob
+{
+public:
+
+    LoadJob(AmiSampleLoader& l, const int s, const juce::File& f, const int g, const bool keep)
+        : juce::ThreadPoolJob("Ami sample load"), loader(l), slot(s), file(f), generation(g), keepSettings(keep) {}
+
+    JobStatus runJob() override
+    {
+        std::unique_ptr<LoadResult_t> result = std::make_unique<LoadResult_t>();
+
+        result->slot = slot;
+        result->file = file;
+        result->generation = generation;
+        result->keepSettings = keepSettings;
+        result->succeeded = loader.decode(*result, this, generation);
+
+        if (loader.shouldStop(slot, this, generation)) return jobHasFinished;
+
+        const juce::ScopedLock sl(loader.finishedLock);
+        loader.finished.add(result.release());
+
+        return jobHasFinished;
+    }
+
+private:
+
+    AmiSampleLoader& loader;
+    const int slot;
+    const juce::File file;
+    const int generation;
+    const bool keepSettings;
+};
+
+//==============================================================================
+AmiSampleLoader::AmiSampleLoader(AmiAudioProcessor& p, juce::AudioFormatManager& formats)
+    : audioProcessor(p), formatManager(formats)
+{
+    allNotes.setRange(0, 128, true);
+
+    for (int n = 0; n < maxSlots; n++)
+    {
+        generation[n] = 0;
+        progress[n] = -1.f;
+    }
+}
+
+AmiSampleLoader::~AmiSampleLoader()
+{
+    cancelAll();
+}
+
+void AmiSampleLoader::loadAsync(const int slot, const juce::File& file, const bool keepSettings)
+{
+    jassert(slot >= 0 && slot < maxSlots);
+
+    const int gen = ++generation[slot];
+
+    progress[slot] = 0.f;
+    pool.addJob(new LoadJob(*this, slot, file, gen, keepSettings), true);
+}
+
+void AmiSampleLoader::cancel(const int slot)
+{
+    ++generation[slot];
+    progress[slot] = -1.f;
+}
+
+void AmiSampleLoader::cancelAll()
+{
+    for (int n = 0; n < maxSlots; n++)
+        cancel(n);
+
+    pool.removeAllJobs(true, 2000);
+
+    const juce::ScopedLock sl(finishedLock);
+    finished.clear();
+}
+
+bool AmiSampleLoader::shouldStop(const int slot, juce::ThreadPoolJob* job, const int gen) const
+{
+    if (job == nullptr) return false;
+
+    return job->shouldExit() || generation[slot].load() != gen;
+}
+
+void AmiSampleLoader::setProgress(const int slot, const int gen, const float value)
+{
+    if (generation[slot].load() == gen) progress[slot] = value;
+}
+
+bool AmiSampleLoader::decode(LoadResult_t& result, juce::ThreadPoolJob* job, const int gen)
+{
+    constexpr int chunkSize = 65536;
+
+    const int slot = result.slot;
+
+    if (!result.file.existsAsFile() || result.file.getSize() <= 0) return false;
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(result.file));
+
+    if (reader == nullptr) return false;
+
+    const int sampleLength = (int) reader->lengthInSamples;
+
+    if (sampleLength <= 1) return false;
+
+    if (audioProcessor.getDiskStream(slot) && sampleLength >= AmiSampleStream::minStreamLength)
+        return decodeStreamed(result, reader, job, gen);
+
+    juce::AudioBuffer<float> samples(1, sampleLength);
+
+    // decoding is most of the work, so it gets most of the progress bar
+
+    for (int pos = 0; pos < sampleLength; pos += chunkSize)
+    {
+        if (shouldStop(slot, job, gen)) return false;
+
+        reader->read(&samples, pos, juce::jmin(chunkSize, sampleLength - pos), pos, true, false);
+        setProgress(slot, gen, 0.9f * (float) juce::jmin(pos + chunkSize, sampleLength) / (float) sampleLength);
+    }
+
+    result.sampleRate = reader->sampleRate;
+
+    const juce::StringPairArray& metaData = reader->metadataValues;
+
+    if (metaData.containsKey("Loop0Start") && metaData.containsKey("Loop0End"))
+    {
+        result.hasLoop = true;
+        result.loopStart = metaData.getValue("Loop0Start", "int").getIntValue();
+        result.loopEnd = metaData.getValue("Loop0End", "int").getIntValue() + 1;
+    }
+
+    if (shouldStop(slot, job, gen)) return false;
+
+    result.data = new AmiSampleBuffer(std::move(samples));
+
+    // quantizes to 8 bits and builds the sample and hold view
+    result.sound = new AmiSamplerSound(result.file.getFileNameWithoutExtension(), slot, result.data,
+                                       result.sampleRate, allNotes, 60, 0.1, 0.1, audioProcessor);
+
+    setProgress(slot, gen, 1.f);
+
+    return true;
+}
+
+bool AmiSampleLoader::decodeStreamed(LoadResult_t& result, std::unique_ptr<juce::AudioFormatReader>& reader,
+                                     juce::ThreadPoolJob* job, const int gen)
+{
+    constexpr int chunkSize = 65536, maxOverviewLength = 1 << 18;
+
+    const int slot = result.slot, sampleLength = (int) reader->lengthInSamples;
+
+    int stride = 1;
+
+    while (sampleLength / stride > maxOverviewLength) stride <<= 1;
+
+    const int headLength = juce::jmin(sampleLength, AmiSampleStream::headLength);
+
+    juce::AudioBuffer<float> overview(1, (sampleLength + stride - 1) / stride), chunk(1, chunkSize);
+    juce::HeapBlock<int8_t> head((size_t) headLength);
+
+    float* view = overview.getWritePointer(0);
+
+    // one pass over the file: keep the head for playback and an overview for the editor
+
+    for (int pos = 0; pos < sampleLength; pos += chunkSize)
+    {
+        if (shouldStop(slot, job, gen)) return false;
+
+        const int num = juce::jmin(chunkSize, sampleLength - pos);
+        const float* in = chunk.getReadPointer(0);
+
+        reader->read(&chunk, 0, num, pos, true, false);
+
+        for (int i = 0; i < num; i++)
+        {
+            const int p = pos + i;
+
+            if (p < headLength) head[p] = AmiSamplerSound::toAmi8Bit(in[i]);
+
+            float& peak = view[p / stride];
+
+            if (p % stride == 0 || std::abs(in[i]) > std::abs(peak)) peak = in[i];
+        }
+
+        setProgress(slot, gen, 0.9f * (float) (pos + num) / (float) sampleLength);
+    }
+
+    result.sampleRate = reader->sampleRate;
+
+    const juce::StringPairArray& metaData = reader->metadataValues;
+
+    if (metaData.containsKey("Loop0Start") && metaData.containsKey("Loop0End"))
+    {
+        result.hasLoop = true;
+        result.loopStart = metaData.getValue("Loop0Start", "int").getIntValue();
+        result.loopEnd = metaData.getValue("Loop0End", "int").getIntValue() + 1;
+    }
+
+    if (shouldStop(slot, job, gen)) return false;
+
+    result.data = new AmiSampleBuffer(std::move(overview), sampleLength, stride);
+
+    // the reader goes with the stream, for the read-ahead thread to use
+    AmiSampleStream::Ptr stream = new AmiSampleStream(result.file, reader.release(), formatManager, std::move(head));
+
+    result.sound = new AmiSamplerSound(result.file.getFileNameWithoutExtension(), slot, stream,
+                                       result.sampleRate, allNotes, 60, 0.1, 0.1, audioProcessor);
+
+    setProgress(slot, gen, 1.f);
+
+    return true;
+}
+
+void AmiSampleLoader::deliverFinished(std::function<void (LoadResult_t&)> apply)
+{
+    juce::OwnedArray<LoadResult_t> ready;
+
+    {
+        const juce::ScopedLock sl(finishedLock);
+        ready.swapWith(finished);
+    }
+
+    for (LoadResult_t* result : ready)
+    {
+        // superseded or cancelled after the job finished: a newer load, or cancel(),
+        // has moved the slot's generation on
+        if (result->generation != generation[result->slot].load()) continue;
+
+        progress[result->slot] = -1.f;
+
+        apply(*result);
+        listeners.call([result](Listener& l) { l.sampleLoadFinished(*result); });
+    }
+}
+
+void AmiSampleLoader::runParallel(const int numItems, std::function<void (int)> work)
+{
+    typedef struct Batch_t
+    {
+    public:
+
+        std::function<void (int)> work;
+        int numItems = 0;
+
+        std::atomic<int> nextItem { 0 }, numDone { 0 };
+        juce::WaitableEvent allDone;
+
+        void runItems()
+        {
+            for (int i = nextItem++; i < numItems; i = nextItem++)
+            {
+                work(i);
+
+                if (++numDone == numItems) allDone.signal();
+            }
+        }
+
+    } Batch_t;
+
+    if (numItems <= 0) return;
+
+    // shared so a helper that only gets a thread after we've returned finds nothing left to do
+    std::shared_ptr<Batch_t> batch = std::make_shared<Batch_t>();
+
+    batch->work = std::move(work);
+    batch->numItems = numItems;
+
+    for (int n = juce::jmin(numItems - 1, pool.getNumThreads()); --n >= 0;)
+        pool.addJob([batch] { batch->runItems(); });
+
+    batch->runItems();
+    batch->allDone.wait();
+}
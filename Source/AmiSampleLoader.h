@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    AmiSampleLoader.h
+    Created: 17 Oct 2026 7:34:05pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AmiSampleBuffer.h"
+
+class AmiAudioProcessor;
+
+/*
+  ==============================================================================
+
+
+  //// Background sample loading ////
+
+  Files are decoded on a small thread pool. Each job reads the file in chunks
+  through the processor's format manager into a shared sample buffer, then
+  builds the slot's 8-bit sound on top of it, so the message thread only has
+  to swap the finished pieces in.
+
+  Loads are tracked per slot: starting a new load or cancelling one bumps the
+  slot's generation, which makes any job still running for it stop at its
+  next chunk and keeps its result from ever being applied.
+
+  ==============================================================================
+*/
+
+class AmiSampleLoader
+{
+public:
+
+    AmiSampleLoader(AmiAudioProcessor&, juce::AudioFormatManager&);
+    ~AmiSampleLoader();
+
+    static constexpr int maxSlots = 12;
+
+    typedef struct LoadResult_t
+    {
+    public:
+
+        int slot = 0;
+        juce::File file;
+
+        // the slot's load generation when the job started; stale once it moves on
+        int generation = 0;
+
+        bool succeeded = false;
+
+        AmiSampleBuffer::Ptr data;
+        double sampleRate = 0.0;
+
+        bool hasLoop = false;
+        int loopStart = 0, loopEnd = 0;
+
+        // reloading the slot's own file (e.g. to switch to or from disk streaming)
+        // keeps its loop settings instead of taking the file's
+        bool keepSettings = false;
+
+        juce::SynthesiserSound::Ptr sound;
+
+    } LoadResult_t;
+
+    class Listener
+    {
+    public:
+
+        virtual ~Listener() = default;
+
+        /** Called on the message thread after the processor has applied a load
+            (or failed to). Cancelled loads are never reported.
+        */
+        virtual void sampleLoadFinished(const LoadResult_t&) = 0;
+    };
+
+    void addListener(Listener* l)    { listeners.add(l); }
+    void removeListener(Listener* l) { listeners.remove(l); }
+
+    /** Starts loading a file into a slot, superseding any load already running for it. */
+    void loadAsync(const int slot, const juce::File& file, const bool keepSettings = false);
+
+    /** Abandons the slot's pending load, if there is one. */
+    void cancel(const int slot);
+
+    /** Stops every job, waiting for them to exit. */
+    void cancelAll();
+
+    /** 0 to 1 while the slot is loading, -1 when it isn't. */
+    float getProgress(const int slot) const { return progress[slot].load(); }
+    bool  isLoading(const int slot) const { return getProgress(slot) >= 0.f; }
+
+    /** Decodes result.file into result for result.slot. Jobs call this with
+        themselves so they can be cancelled; pass nullptr to load synchronously.
+    */
+    bool decode(LoadResult_t& result, juce::ThreadPoolJob* job, const int generation);
+
+    /** Message thread: passes every finished, still-current load to apply and
+        then to the listeners.
+    */
+    void deliverFinished(std::function<void (LoadResult_t&)> apply);
+
+    /** Calls work(0) to work(numItems - 1) spread across the pool and the
+        calling thread, and returns once every call has finished.
+    */
+    void runParallel(const int numItems, std::function<void (int)> work);
+
+    /** Queues a one-off job on the pool. */
+    void runInBackground(std::function<void()> job) { pool.addJob(std::move(job)); }
+
+private:
+
+    class LoadJob;
+
+    /** decode() for a slot set to stream from disk: keeps the reader open for the stream. */
+    bool decodeStreamed(LoadResult_t& result, std::unique_ptr<juce::AudioFormatReader>& reader,
+                        juce::ThreadPoolJob* job, const int generation);
+
+    bool shouldStop(const int slot, juce::ThreadPoolJob* job, const int generation) const;
+    void setProgress(const int slot, const int generation, const float value);
+
+    AmiAudioProcessor& audioProcessor;
+    juce::AudioFormatManager& formatManager;
+
+    juce::BigInteger allNotes;
+
+    std::atomic<int> generation[maxSlots];
+    std::atomic<float> progress[maxSlots];
+
+    juce::CriticalSection finishedLock;
+    juce::OwnedArray<LoadResult_t> finished;
+
+    juce::ListenerList<Listener> listeners;
+
+    juce::ThreadPool pool { juce::jlimit(2, 8, juce::SystemStats::getNumCpus() - 1) };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSampleLoader)
+};
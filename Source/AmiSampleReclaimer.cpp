@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    AmiSampleReclaimer.cpp
+    Created: 17 Oct 2026 6:15:31pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSampleReclaimer.h"
+
+AmiSampleReclaimer::AmiSampleReclaimer(const std::atomic<uint32_t>& epoch) 
+    : juce::Thread("Ami sample reclaimer"), renderEpoch(epoch)
+{
+    startThread();
+}
+
+AmiSampleReclaimer::~AmiSampleReclaimer()
+{
+    stopThread(1000);
+
+    // nothing is rendering any more, so whatever is left only needs its reference dropped
+    reclaim(true);
+}
+
+void AmiSampleReclaimer::retire(juce::ReferenceCountedObject* object)
+{
+    if (object == nullptr) return;
+
+    {
+        const juce::ScopedLock sl(retiredLock);
+        retired.add({ object, renderEpoch.load() });
+    }
+
+    notify();
+}
+
+void AmiSampleReclaimer::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(250);
+        reclaim(false);
+    }
+}
+
+void AmiSampleReclaimer::reclaim(const bool force)
+{
+    juce::Array<juce::ReferenceCountedObject*> released;
+
+    {
+        const juce::ScopedLock sl(retiredLock);
+
+        const uint32_t epoch = renderEpoch.load();
+
+        for (int i = retired.size(); --i >= 0;)
+        {
+            const Retired_t& r = retired.getReference(i);
+
+            // retired mid-block (odd epoch): wait for that block to end. After
+            // that only voices can still hold it, and they let go when they stop.
+            const bool blockOver = (r.epoch & 1) == 0 || epoch != r.epoch;
+
+            if (force || (blockOver && r.object->getReferenceCount() == 1))
+            {
+                released.add(r.object);
+                retired.remove(i);
+            }
+        }
+    }
+
+    for (juce::ReferenceCountedObject* object : released)
+        object->decReferenceCount();
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    AmiSampleReclaimer.h
+    Created: 17 Oct 2026 6:15:31pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Deferred release of unpublished sample objects ////
+
+  When a slot's sound is swapped out, the render thread may still be halfway
+  through a block that picked up the old pointer, and voices may still be
+  playing it. Instead of dropping it there and then, the message thread hands
+  its reference over here.
+
+  The processor bumps a render epoch at the start and end of every block (odd
+  while a block is running). A retired object is released on this thread once
+  the block that might have seen it is over and nothing else references it, so
+  the audio thread never frees sample data and never waits on a lock.
+
+  ==============================================================================
+*/
+
+class AmiSampleReclaimer : private juce::Thread
+{
+public:
+
+    AmiSampleReclaimer(const std::atomic<uint32_t>& renderEpoch);
+    ~AmiSampleReclaimer() override;
+
+    /** Takes over one reference to an object that has just been unpublished.
+        Call this after the swap, from the message thread.
+    */
+    void retire(juce::ReferenceCountedObject* object);
+
+private:
+
+    void run() override;
+    void reclaim(const bool force);
+
+    typedef struct Retired_t
+    {
+    public:
+
+        juce::ReferenceCountedObject* object;
+        uint32_t epoch;
+
+    } Retired_t;
+
+    const std::atomic<uint32_t>& renderEpoch;
+
+    juce::CriticalSection retiredLock;
+    juce::Array<Retired_t> retired;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSampleReclaimer)
+};
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    AmiSampleStore.cpp
+    Created: 17 Oct 2026 10:26:51pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSampleStore.h"
+
+AmiSampleStore::AmiSampleStore()
+{
+    for (int n = 0; n < maxSlots; n++)
+        dirty[n] = true;
+}
+
+AmiSampleStore::~AmiSampleStore() {}
+
+void AmiSampleStore::markDirty(const int slot)
+{
+    jassert(slot >= 0 && slot < maxSlots);
+
+    const juce::ScopedLock sl(lock);
+
+    dirty[slot] = true;
+    chunks[slot].payload.reset();
+}
+
+void AmiSampleStore::setChunk(const int slot, AmiStateFormat::SampleChunk_t&& chunk)
+{
+    jassert(slot >= 0 && slot < maxSlots);
+
+    const juce::ScopedLock sl(lock);
+
+    chunks[slot] = std::move(chunk);
+    dirty[slot] = false;
+}
+
+const AmiStateFormat::SampleChunk_t& AmiSampleStore::getChunk(const int slot, const juce::AudioBuffer<float>& wave)
+{
+    jassert(slot >= 0 && slot < maxSlots);
+
+    const juce::ScopedLock sl(lock);
+
+    if (dirty[slot])
+    {
+        AmiStateFormat::encodeChunk(wave.getNumSamples() > 0 ? wave.getReadPointer(0) : nullptr,
+                                    wave.getNumSamples(), chunks[slot]);
+        dirty[slot] = false;
+    }
+
+    return chunks[slot];
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    AmiSampleStore.h
+    Created: 17 Oct 2026 10:26:51pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AmiStateFormat.h"
+
+/*
+  ==============================================================================
+
+
+  //// Encoded sample cache for the plugin state ////
+
+  Sample data is kept out of the APVTS tree. Instead each slot's encoded
+  state chunk is cached here and only rebuilt, at save time, when the slot's
+  samples have changed since the last save, so repeated host autosaves of an
+  unchanged session don't re-encode any audio.
+
+  ==============================================================================
+*/
+
+class AmiSampleStore
+{
+public:
+
+    AmiSampleStore();
+    ~AmiSampleStore();
+
+    static constexpr int maxSlots = 12;
+
+    /** The slot's samples changed; its chunk is rebuilt at the next save. */
+    void markDirty(const int slot);
+
+    /** Primes a slot with a chunk that already matches its samples, as read from a saved state. */
+    void setChunk(const int slot, AmiStateFormat::SampleChunk_t&& chunk);
+
+    /** Returns the slot's chunk, encoding wave first if the slot is dirty.
+        Hold getLock() while using the result.
+    */
+    const AmiStateFormat::SampleChunk_t& getChunk(const int slot, const juce::AudioBuffer<float>& wave);
+
+    const juce::CriticalSection& getLock() const { return lock; }
+
+private:
+
+    juce::CriticalSection lock;
+
+    AmiStateFormat::SampleChunk_t chunks[maxSlots];
+    bool dirty[maxSlots];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSampleStore)
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    AmiSampleStream.cpp
+    Created: 18 Oct 2026 4:02:37pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSampleStream.h"
+#include "AmiSamplerSound.h"
+
+AmiSampleStream::AmiSampleStream(const juce::File& f, juce::AudioFormatReader* r,
+                                 juce::AudioFormatManager& formats, juce::HeapBlock<int8_t>&& headData)
+    : file(f), formatManager(formats), reader(r), head(std::move(headData))
+{
+    jassert(reader != nullptr);
+
+    length = (int) reader->lengthInSamples;
+
+    // like the in-memory path, only the left channel is played
+    numChannels = 1;
+}
+
+AmiSampleStream::~AmiSampleStream()
+{
+    if (LoopRegion_t* region = pendingLoop.exchange(nullptr)) region->decReferenceCount();
+    if (LoopRegion_t* region = loop.exchange(nullptr))        region->decReferenceCount();
+}
+
+bool AmiSampleStream::readInto(juce::AudioFormatReader& source, juce::AudioBuffer<float>& scratch, int8_t* const* dest,
+                               const int mask, const int destStart, const int fileStart, const int numSamples)
+{
+    constexpr int blockSize = 8192;
+
+    if (scratch.getNumSamples() < blockSize) scratch.setSize(1, blockSize);
+
+    for (int done = 0; done < numSamples; done += blockSize)
+    {
+        const int num = juce::jmin(blockSize, numSamples - done);
+
+        if (!source.read(&scratch, 0, num, fileStart + done, true, false)) return false;
+
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            const float* in = scratch.getReadPointer(ch);
+
+            for (int i = 0; i < num; i++)
+                dest[ch][(destStart + done + i) & mask] = AmiSamplerSound::toAmi8Bit(in[i]);
+        }
+    }
+
+    return true;
+}
+
+bool AmiSampleStream::readAhead(int8_t* const* dest, const int mask, const int start, const int numSamples)
+{
+    return readInto(*reader, readScratch, dest, mask, start, start, numSamples);
+}
+
+bool AmiSampleStream::readAll(juce::AudioBuffer<float>& dest)
+{
+    std::unique_ptr<juce::AudioFormatReader> source(formatManager.createReaderFor(file));
+
+    if (source == nullptr || (int) source->lengthInSamples != length) return false;
+
+    dest.setSize(1, length);
+
+    return source->read(&dest, 0, length, 0, true, false);
+}
+
+bool AmiSampleStream::claimLoopLoad(const int loopStart, const int loopEnd, const bool pingPong)
+{
+    const int start = juce::jlimit(0, length, loopStart), end = juce::jlimit(start, length, loopEnd);
+
+    if (loopLoading.load() || (start == requestedLoopStart && end == requestedLoopEnd && pingPong == requestedPingPong)) return false;
+
+    requestedLoopStart = start;
+    requestedLoopEnd = end;
+    requestedPingPong = pingPong;
+    loopLoading = true;
+
+    return true;
+}
+
+void AmiSampleStream::loadLoopRegion(const int loopStart, const int loopEnd, const bool pingPong)
+{
+    const int start = juce::jlimit(0, length, loopStart), end = juce::jlimit(start, length, loopEnd);
+    const int loopLength = end - start, regionLength = pingPong ? 2 * loopLength : loopLength;
+
+    juce::ReferenceCountedObjectPtr<LoopRegion_t> region = new LoopRegion_t();
+
+    region->start = start;
+    region->end = start;
+
+    // a forward loop inside the head is already resident; a ping-pong one still
+    // needs its reversed half
+    if (loopLength > 0 && (end > getHeadLength() || pingPong))
+    {
+        region->storage.malloc((size_t) (regionLength * numChannels));
+
+        for (int ch = 0; ch < numChannels; ch++)
+            region->data[ch] = region->storage.get() + ch * regionLength;
+
+        int8_t* dest[2] = { region->storage.get(), region->storage.get() + regionLength };
+        bool read = true;
+
+        if (end > getHeadLength())
+        {
+            std::unique_ptr<juce::AudioFormatReader> source(formatManager.createReaderFor(file));
+            juce::AudioBuffer<float> scratch;
+
+            read = source != nullptr && readInto(*source, scratch, dest, -1, 0, start, loopLength);
+        }
+        else
+        {
+            for (int ch = 0; ch < numChannels; ch++)
+                std::copy(getHead(ch) + start, getHead(ch) + end, dest[ch]);
+        }
+
+        if (read)
+        {
+            if (pingPong)
+            {
+                for (int ch = 0; ch < numChannels; ch++)
+                    std::reverse_copy(dest[ch], dest[ch] + loopLength, dest[ch] + loopLength);
+
+                region->mirrorEnd = end;
+            }
+
+            region->end = start + regionLength;
+        }
+        else
+        {
+            requestedLoopStart = -1;
+        }
+    }
+
+    region->incReferenceCount();
+
+    if (LoopRegion_t* old = pendingLoop.exchange(region.get())) old->decReferenceCount();
+
+    loopLoading = false;
+}
+
+AmiSampleStream::LoopRegion_t* AmiSampleStream::publishLoopRegion()
+{
+    LoopRegion_t* region = pendingLoop.exchange(nullptr);
+
+    if (region == nullptr) return nullptr;
+
+    return loop.exchange(region, std::memory_order_acq_rel);
+}
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+
+    AmiSampleStream.h
+    Created: 18 Oct 2026 4:02:37pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Direct-from-disk sample ////
+
+  A long sample played straight from its file. Only the head of the sample
+  and its loop region are kept in memory, already quantized to Paula's 8 bits.
+  Everything else is read ahead into each playing voice's ring buffer by
+  AmiDiskStreamer.
+
+  The head covers the time it takes the read-ahead to get going after a note
+  starts. The loop region is a separate immutable block that is swapped in
+  whole when the loop points move, so a looping voice never waits on the disk
+  once it has wrapped.
+
+  ==============================================================================
+*/
+
+class AmiSampleStream : public juce::ReferenceCountedObject
+{
+public:
+
+    typedef juce::ReferenceCountedObjectPtr<AmiSampleStream> Ptr;
+
+    static constexpr int headLength = 1 << 17;
+
+    /** Samples shorter than this are cheaper to keep in memory than to stream. */
+    static constexpr int minStreamLength = 4 * headLength;
+
+    /** Takes over the reader, which the read-ahead thread then uses on its own.
+        head holds the first min(length, headLength) samples of each channel.
+    */
+    AmiSampleStream(const juce::File& file, juce::AudioFormatReader* reader,
+                    juce::AudioFormatManager& formats, juce::HeapBlock<int8_t>&& head);
+    ~AmiSampleStream() override;
+
+    typedef struct LoopRegion_t : public juce::ReferenceCountedObject
+    {
+    public:
+
+        int start = 0, end = 0;
+
+        // ping-pong loops: [start, mirrorEnd) followed by the same samples backwards,
+        // up to end (0 for a forward loop)
+        int mirrorEnd = 0;
+
+        juce::HeapBlock<int8_t> storage;
+        const int8_t* data[2] = { nullptr, nullptr };
+
+    } LoopRegion_t;
+
+    const juce::File& getFile() const noexcept { return file; }
+
+    int getLength() const noexcept      { return length; }
+    int getNumChannels() const noexcept { return numChannels; }
+    int getHeadLength() const noexcept  { return juce::jmin(length, headLength); }
+
+    const int8_t* getHead(const int channel) const noexcept
+    {
+        return channel < numChannels ? head.get() + channel * getHeadLength() : nullptr;
+    }
+
+    /** The loop region the render thread should read, or nullptr. */
+    const LoopRegion_t* getLoopRegion() const noexcept { return loop.load(std::memory_order_acquire); }
+
+    //==============================================================================
+    /** Read-ahead thread: quantizes numSamples from start into dest, which wraps
+        at mask + 1 samples per channel. Returns false if the file couldn't be read.
+    */
+    bool readAhead(int8_t* const* dest, const int mask, const int start, const int numSamples);
+
+    /** Reads the whole sample back as float, for exporting or resampling it. Slow. */
+    bool readAll(juce::AudioBuffer<float>& dest);
+
+    //==============================================================================
+    /** Message thread: true once, when the resident loop doesn't match these
+        points and no load is running; the caller then runs loadLoopRegion().
+    */
+    bool claimLoopLoad(const int loopStart, const int loopEnd, const bool pingPong);
+
+    /** Background thread: reads the loop region, unrolled into its reverse for a
+        ping-pong loop, to be picked up by publishLoopRegion().
+    */
+    void loadLoopRegion(const int loopStart, const int loopEnd, const bool pingPong);
+
+    /** Message thread: swaps in a newly loaded loop region and returns the one
+        it replaces, whose reference the caller must retire.
+    */
+    LoopRegion_t* publishLoopRegion();
+
+private:
+
+    bool readInto(juce::AudioFormatReader& source, juce::AudioBuffer<float>& scratch, int8_t* const* dest,
+                  const int mask, const int destStart, const int fileStart, const int numSamples);
+
+    const juce::File file;
+    juce::AudioFormatManager& formatManager;
+
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::AudioBuffer<float> readScratch;
+
+    int length = 0, numChannels = 0;
+    juce::HeapBlock<int8_t> head;
+
+    std::atomic<LoopRegion_t*> loop { nullptr }, pendingLoop { nullptr };
+    std::atomic<bool> loopLoading { false };
+    // set back to -1 by a load that couldn't read the file, so the next claim retries it
+    std::atomic<int> requestedLoopStart { -1 };
+    int requestedLoopEnd = -1;
+    bool requestedPingPong = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSampleStream)
+};
@@ -35,6 +35,7 @@
 
 #include <JuceHeader.h>
 #include "AmiSamplerSound.h"
+#include "AmiSynthesiser.h"
 
 /*
   ==============================================================================
@@ -47,7 +48,7 @@
 */
 
 AmiSamplerSound::AmiSamplerSound (const juce::String& soundName, int sampleNumber,
-                        juce::AudioSampleBuffer& source, const double& sampleRate,
+                        AmiSampleBuffer::Ptr source, const double& sampleRate,
                         const juce::BigInteger& notes,
                         int midiNoteForNormalPitch,
                         double attackTimeSecs,
@@ -58,11 +59,50 @@ AmiSamplerSound::AmiSamplerSound (const juce::String& soundName, int sampleNumbe
       midiNotes (notes),
       midiRootNote (midiNoteForNormalPitch), audioProcessor(p)
 {
-    if (sourceSampleRate > 0 && source.getNumSamples() > 0)
+    if (sourceSampleRate > 0 && source != nullptr && source->getNumSamples() > 0)
     {
-        data.reset();
-        data = std::make_unique<juce::AudioSampleBuffer>(source);
-        length = source.getNumSamples();
+        data = source;
+        length = source->getNumSamples();
+        numChannels = juce::jmin(source->getNumChannels(), 2);
+
+        ami8BitData.allocate(length, numChannels);
+
+        for (int ch = 0; ch < numChannels; ch++)
+        {
+            const float* in = source->getReadPointer(ch);
+            int8_t* out = ami8BitData.getRun(ch);
+
+            for (int i = 0; i < length; i++)
+                out[i] = toAmi8Bit(in[i]);
+        }
+
+        setSampleAndHold(audioProcessor.getSnH(sampleNumber));
+
+        params.attack  = static_cast<float> (attackTimeSecs);
+        params.release = static_cast<float> (releaseTimeSecs);
+
+        currentSample = sampleNumber;
+    }
+}
+
+AmiSamplerSound::AmiSamplerSound (const juce::String& soundName, int sampleNumber,
+                        AmiSampleStream::Ptr source, const double& sampleRate,
+                        const juce::BigInteger& notes,
+                        int midiNoteForNormalPitch,
+                        double attackTimeSecs,
+                        double releaseTimeSecs,
+                        AmiAudioProcessor& p)
+    : name (soundName),
+      stream (source),
+      sourceSampleRate (sampleRate),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch), audioProcessor(p)
+{
+    // no 8-bit copy, hold views or pyramid: those would need the whole sample in memory
+    if (sourceSampleRate > 0 && source != nullptr && source->getLength() > 0)
+    {
+        length = source->getLength();
+        numChannels = source->getNumChannels();
 
         params.attack  = static_cast<float> (attackTimeSecs);
         params.release = static_cast<float> (releaseTimeSecs);
@@ -73,6 +113,320 @@ AmiSamplerSound::AmiSamplerSound (const juce::String& soundName, int sampleNumbe
 
 AmiSamplerSound::~AmiSamplerSound()
 {
+    if (UnrolledLoop_t* unrolled = pendingUnrolledLoop.exchange(nullptr)) unrolled->decReferenceCount();
+    if (UnrolledLoop_t* unrolled = unrolledLoop.exchange(nullptr))        unrolled->decReferenceCount();
+}
+
+int8_t AmiSamplerSound::toAmi8Bit(const float samp)
+{
+    const float amiSamp = samp < 0 ? std::floor(samp * 128.f) : std::floor(samp * 127.f);
+
+    return (int8_t) juce::jlimit(-128.f, 127.f, amiSamp);
+}
+
+void AmiSamplerSound::setSampleAndHold(const int snh)
+{
+    const int hold = juce::jlimit(1, maxHold, std::abs(snh));
+    std::unique_ptr<HoldView_t>& view = holdViews[hold - 1];
+
+    if (numChannels <= 0 || stream != nullptr) return;
+
+    if (view == nullptr)
+    {
+        view = std::make_unique<HoldView_t>();
+        view->data[0] = view->data[1] = nullptr;
+
+        if (hold == 1)
+        {
+            for (int ch = 0; ch < numChannels; ch++)
+                view->data[ch] = ami8BitData.getRun(ch);
+        }
+        else
+        {
+            view->storage.allocate(length, numChannels);
+
+            for (int ch = 0; ch < numChannels; ch++)
+            {
+                int8_t* held = view->storage.getRun(ch);
+                const int8_t* in = ami8BitData.getRun(ch);
+
+                for (int i = 0; i < length; i += hold)
+                    std::fill(held + i, held + juce::jmin(i + hold, length), in[i]);
+
+                view->data[ch] = held;
+            }
+        }
+    }
+
+    currentHoldView.store(view.get(), std::memory_order_release);
+}
+
+void AmiSamplerSound::getMipLevels(AmiVoiceBank::SlotState_t& slot)
+{
+    const MipPyramid_t* levels = pyramid.load(std::memory_order_acquire);
+
+    slot.numMipLevels = 1;
+
+    if (levels == nullptr)
+    {
+        int expected = pyramidNone;
+        pyramidState.compare_exchange_strong(expected, pyramidRequested);
+
+        return;
+    }
+
+    for (int n = 1; n < levels->numLevels; n++)
+    {
+        slot.mipL[n] = levels->data[0][n];
+        slot.mipR[n] = levels->data[1][n];
+        slot.mipLength[n] = levels->length[n];
+    }
+
+    slot.numMipLevels = levels->numLevels;
+}
+
+bool AmiSamplerSound::claimPyramidRequest()
+{
+    int expected = pyramidRequested;
+
+    return pyramidState.compare_exchange_strong(expected, pyramidBuilding);
+}
+
+void AmiSamplerSound::buildPyramid()
+{
+    // 31-tap Blackman windowed sinc with its cutoff at half the band, so each
+    // level can drop every other sample of the one above without aliasing
+    static constexpr int numTaps = 31, halfTaps = numTaps / 2;
+
+    static const struct HalfBand_t
+    {
+        HalfBand_t()
+        {
+            constexpr double pi = juce::MathConstants<double>::pi;
+            double sum = 0.0;
+
+            for (int t = 0; t < numTaps; t++)
+            {
+                const double x = (double) (t - halfTaps);
+                const double sinc = x == 0.0 ? 0.5 : std::sin(0.5 * pi * x) / (pi * x);
+                const double window = 0.42 - 0.5 * std::cos(2.0 * pi * t / (numTaps - 1)) + 0.08 * std::cos(4.0 * pi * t / (numTaps - 1));
+
+                taps[t] = sinc * window;
+                sum += taps[t];
+            }
+
+            for (int t = 0; t < numTaps; t++)
+                taps[t] /= sum;
+        }
+
+        double taps[numTaps];
+
+    } halfBand;
+
+    constexpr int minLevelLength = 16;
+
+    if (numChannels <= 0 || data == nullptr || pyramid.load() != nullptr) return;
+
+    std::unique_ptr<MipPyramid_t> levels = std::make_unique<MipPyramid_t>();
+
+    int numLevels = 1;
+
+    levels->length[0] = length;
+
+    while (numLevels < AmiVoiceBank::maxMipLevels && levels->length[numLevels - 1] / 2 >= minLevelLength)
+    {
+        levels->length[numLevels] = (levels->length[numLevels - 1] + 1) / 2;
+        numLevels++;
+    }
+
+    levels->numLevels = numLevels;
+
+    // one run per channel and level below the first, channel by channel
+    int runLengths[2 * AmiVoiceBank::maxMipLevels];
+
+    for (int ch = 0; ch < numChannels; ch++)
+        for (int n = 1; n < numLevels; n++)
+            runLengths[ch * (numLevels - 1) + n - 1] = levels->length[n];
+
+    levels->storage.allocate(runLengths, numChannels * (numLevels - 1));
+
+    for (int ch = 0; ch < 2; ch++)
+        levels->data[ch][0] = ch < numChannels ? ami8BitData.getRun(ch) : nullptr;
+
+    for (int ch = 0; ch < numChannels; ch++)
+    {
+        // filter in float from the original samples, quantizing each level as Paula would play it
+        std::vector<float> above(data->getReadPointer(ch), data->getReadPointer(ch) + length), below;
+
+        for (int n = 1; n < numLevels; n++)
+        {
+            const int aboveLength = levels->length[n - 1], belowLength = levels->length[n];
+
+            below.resize((size_t) belowLength);
+
+            int8_t* out = levels->storage.getRun(ch * (numLevels - 1) + n - 1);
+
+            for (int i = 0; i < belowLength; i++)
+            {
+                double sum = 0.0;
+
+                for (int t = 0; t < numTaps; t++)
+                    sum += halfBand.taps[t] * above[(size_t) juce::jlimit(0, aboveLength - 1, 2 * i + t - halfTaps)];
+
+                below[(size_t) i] = (float) sum;
+                out[i] = toAmi8Bit(below[(size_t) i]);
+            }
+
+            levels->data[ch][n] = out;
+
+            above.swap(below);
+        }
+    }
+
+    if (numChannels < 2)
+        for (int n = 1; n < numLevels; n++)
+            levels->data[1][n] = nullptr;
+
+    pyramidStorage = std::move(levels);
+    pyramid.store(pyramidStorage.get(), std::memory_order_release);
+    pyramidState = pyramidBuilt;
+}
+
+bool AmiSamplerSound::getUnrolledLoop(AmiVoiceBank::SlotState_t& slot, const bool pingPong) const
+{
+    const UnrolledLoop_t* unrolled = unrolledLoop.load(std::memory_order_acquire);
+
+    // a copy left from other loop points or another hold would play the wrong loop
+    if (unrolled == nullptr || unrolled->pingPong != pingPong
+         || unrolled->loopStart != slot.loopStart || unrolled->loopEnd != slot.loopEnd
+         || unrolled->holdView != currentHoldView.load(std::memory_order_acquire)) return false;
+
+    slot.inL = unrolled->data[0][0];
+    slot.inR = unrolled->data[1][0];
+
+    slot.length    = unrolled->length[0];
+    slot.loopEnd   = unrolled->length[0];
+    slot.mirrorEnd = pingPong ? unrolled->loopEnd : 0;
+
+    // only the levels the pyramid had when the copy was made
+    slot.numMipLevels = juce::jmin(slot.numMipLevels, unrolled->numLevels);
+
+    for (int n = 1; n < slot.numMipLevels; n++)
+    {
+        slot.mipL[n] = unrolled->data[0][n];
+        slot.mipR[n] = unrolled->data[1][n];
+        slot.mipLength[n] = unrolled->length[n];
+    }
+
+    return true;
+}
+
+bool AmiSamplerSound::claimLoopUnroll(const int loopStart, const int loopEnd, const bool pingPong)
+{
+    const HoldView_t* view = currentHoldView.load(std::memory_order_acquire);
+    const MipPyramid_t* levels = pyramid.load(std::memory_order_acquire);
+
+    if (numChannels <= 0 || stream != nullptr || unrolling.load()) return false;
+
+    // loop points outside the sample play from the sample itself, as they always have
+    if (loopStart < 0 || loopStart >= loopEnd || loopEnd > length) return false;
+
+    if (loopStart == requestedUnrollStart && loopEnd == requestedUnrollEnd && pingPong == requestedUnrollPingPong
+         && view == requestedUnrollView && levels == requestedUnrollLevels) return false;
+
+    requestedUnrollStart = loopStart;
+    requestedUnrollEnd = loopEnd;
+    requestedUnrollPingPong = pingPong;
+    requestedUnrollView = view;
+    requestedUnrollLevels = levels;
+    unrolling = true;
+
+    return true;
+}
+
+void AmiSamplerSound::unrollLoop(const int loopStart, const int loopEnd, const bool pingPong)
+{
+    const HoldView_t* view = currentHoldView.load(std::memory_order_acquire);
+    const MipPyramid_t* levels = pyramid.load(std::memory_order_acquire);
+
+    const int start = loopStart, end = loopEnd;
+
+    jassert(start >= 0 && start < end && end <= length);
+
+    juce::ReferenceCountedObjectPtr<UnrolledLoop_t> unrolled = new UnrolledLoop_t();
+
+    unrolled->loopStart = loopStart;
+    unrolled->loopEnd = loopEnd;
+    unrolled->pingPong = pingPong;
+    unrolled->holdView = view;
+    unrolled->levels = levels;
+
+    // each level holds the loop at its own resolution, as long as the loop is
+    // still at least a sample long there
+    const int maxLevels = levels != nullptr ? levels->numLevels : 1;
+    int levelStart[AmiVoiceBank::maxMipLevels], levelEnd[AmiVoiceBank::maxMipLevels];
+
+    while (unrolled->numLevels < maxLevels)
+    {
+        const int n = unrolled->numLevels;
+        const int e = n > 0 ? juce::jmin(end >> n, levels->length[n]) : end, s = start >> n;
+
+        if (e <= s) break;
+
+        levelStart[n] = s;
+        levelEnd[n] = e;
+        unrolled->length[n] = pingPong ? e + (e - s) : e;
+        unrolled->numLevels++;
+    }
+
+    // one run per channel and level, channel by channel
+    int runLengths[2 * AmiVoiceBank::maxMipLevels];
+
+    for (int ch = 0; ch < numChannels; ch++)
+        for (int n = 0; n < unrolled->numLevels; n++)
+            runLengths[ch * unrolled->numLevels + n] = unrolled->length[n];
+
+    unrolled->storage.allocate(runLengths, numChannels * unrolled->numLevels);
+
+    for (int ch = 0; ch < 2; ch++)
+    {
+        for (int n = 0; n < unrolled->numLevels; n++)
+        {
+            unrolled->data[ch][n] = nullptr;
+
+            if (ch >= numChannels) continue;
+
+            const int8_t* in = n > 0 ? levels->data[ch][n] : view->data[ch];
+            const int s = levelStart[n], e = levelEnd[n], len = unrolled->length[n];
+
+            int8_t* out = unrolled->storage.getRun(ch * unrolled->numLevels + n);
+
+            std::copy(in, in + e, out);
+
+            if (pingPong) std::reverse_copy(in + s, in + e, out + e);
+
+            // the guard after the end carries on round the loop, so taps read across the wrap
+            for (int i = 0; i < AmiSampleBlock::guardLength; i++)
+                out[len + i] = out[s + i % (len - s)];
+
+            unrolled->data[ch][n] = out;
+        }
+    }
+
+    unrolled->incReferenceCount();
+
+    if (UnrolledLoop_t* old = pendingUnrolledLoop.exchange(unrolled.get())) old->decReferenceCount();
+
+    unrolling = false;
+}
+
+juce::ReferenceCountedObject* AmiSamplerSound::publishUnrolledLoop()
+{
+    UnrolledLoop_t* unrolled = pendingUnrolledLoop.exchange(nullptr);
+
+    if (unrolled == nullptr) return nullptr;
+
+    return unrolledLoop.exchange(unrolled, std::memory_order_acq_rel);
 }
 
 bool AmiSamplerSound::appliesToNote (int midiNoteNumber)
@@ -94,8 +448,10 @@ bool AmiSamplerSound::appliesToChannel (int midiChannel)
 }
 
 //==============================================================================
-AmiSamplerVoice::AmiSamplerVoice(AmiAudioProcessor& p) : audioProcessor(p)
+AmiSamplerVoice::AmiSamplerVoice(AmiAudioProcessor& p, AmiVoicePool& voicePool, const int voiceLane) 
+    : pool(voicePool), bank(voicePool.getVoiceBank()), lane(voiceLane), audioProcessor(p)
 {
+    bank.resetLane(lane);
 }
 
 AmiSamplerVoice::~AmiSamplerVoice() {}
@@ -112,38 +468,58 @@ void AmiSamplerVoice::startNote (int midiNoteNumber, float velocity, juce::Synth
         const double playbackSampleRate = audioProcessor.getSourceSampleRate((currentSample = sound->currentSample));
         const double devSampleRate = audioProcessor.getDevSampleRate();
 
+        int64_t& pitchRatio  = bank.pitch[lane];
+        int64_t& pitchTarget = bank.pitchTarget[lane];
+
         sound->midiRootNote = 120 - audioProcessor.getRootNote(currentSample);
 
-        if (sourceSamplePosition >= sound->length) releasedNote = true;
+        if (getSamplePosition() >= sound->length) releasedNote = true;
 
-        numVoices = audioProcessor.getSampler(currentSample).getNumVoices();
+        numVoices = audioProcessor.getSampler(currentSample).getVoiceLimit();
 
-        bendRatio = std::pow(2., ((double) pitchwheel - 8192.) / 49152.);
-        fineTune  = 1 + audioProcessor.getFineTune(currentSample) / 1200.;
+        bank.bend[lane] = std::pow(2., ((double) pitchwheel - 8192.) / 49152.);
 
-        pitchTarget = std::pow(2., (double) (midiNoteNumber - sound->midiRootNote) / 12.) * playbackSampleRate / devSampleRate;
+        noteSemitones = midiNoteNumber - sound->midiRootNote;
+        rateRatio = playbackSampleRate / devSampleRate;
 
-        slideUp = (pitchTarget > pitchRatio);
+        pitchTarget = AmiVoiceBank::getNoteIncrement(noteSemitones, audioProcessor.getFineTune(currentSample), rateRatio);
 
-        lgain = audioProcessor.shouldPan(currentSample, 0) ? 0 : velocity;
-        rgain = audioProcessor.shouldPan(currentSample, 1) ? 0 : velocity;
+        bank.slideUp[lane] = (pitchTarget > pitchRatio);
+
+        bank.gainL[lane] = audioProcessor.shouldPan(currentSample, 0) ? 0 : velocity;
+        bank.gainR[lane] = audioProcessor.shouldPan(currentSample, 1) ? 0 : velocity;
 
         audioProcessor.incPanCount(currentSample);
 
         adsr.setSampleRate(devSampleRate);
         adsr.setParameters(sound->params);
         
-        glissRatio = (pitchTarget - pitchRatio) / (audioProcessor.getGlissando(currentSample) * devSampleRate * 0.01);
+        const double glideSamples = juce::jmax(1.0, audioProcessor.getGlissando(currentSample) * devSampleRate * 0.01);
+        int64_t& glissStep = bank.glissStep[lane];
+
+        glissStep = (int64_t) ((double) (pitchTarget - pitchRatio) / glideSamples);
+
+        // a glide too slow to show in the bottom bit still has to get there
+        if (glissStep == 0 && pitchTarget != pitchRatio) glissStep = pitchTarget > pitchRatio ? 1 : -1;
 
         if (releasedNote || numVoices > 1 || audioProcessor.getGlissando(currentSample) <= 1)
         {
-            sourceSamplePosition = 0.0;
+            bank.position[lane] = 0;
+            bank.playForward[lane] = true;
+            bank.clearBlep(lane);
+
+            attachStream(sound->getStream());
 
             pitchRatio = pitchTarget;
             releasedNote = false;
 
             adsr.noteOn();
         }
+        else if (sound->getStream() != attachedStream)
+        {
+            // gliding on into a different sound: its ring refills from where we are
+            attachStream(sound->getStream());
+        }
     }
     else
     {
@@ -157,19 +533,31 @@ void AmiSamplerVoice::stopNote (float /*velocity*/, bool allowTailOff)
     {
         adsr.noteOff();
         releasedNote = true;
+
+        pool.voiceReleased(*this);
     }
     else
     {
         clearCurrentNote();
+        attachStream(nullptr);
+
         if (releasedNote || (numVoices <= 1 && audioProcessor.getGlissando(currentSample) <= 1)) adsr.reset();
+
+        pool.voiceStopped(*this);
     }
 
     audioProcessor.setSamplePos(0);
 }
 
+void AmiSamplerVoice::resetNoteState()
+{
+    releasedNote = true;
+    adsr.reset();
+}
+
 void AmiSamplerVoice::pitchWheelMoved(int newValue)
 {
-    bendRatio = std::pow(2., ((double) newValue - 8192.0) / 49152.0);
+    bank.bend[lane] = std::pow(2., ((double) newValue - 8192.0) / 49152.0);
 }
 
 void AmiSamplerVoice::controllerMoved (int /*controllerNumber*/, int /*newValue*/) {}
@@ -177,121 +565,186 @@ void AmiSamplerVoice::controllerMoved (int /*controllerNumber*/, int /*newValue*
 //==============================================================================
 void AmiSamplerVoice::renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
 {
-    if(audioProcessor.isMuted(currentSample)) return;
+    AmiSamplerVoice* self = this;
 
-    if (AmiSamplerSound* playingSound = static_cast<AmiSamplerSound*> (getCurrentlyPlayingSound().get()))
-    {
-        auto& data = *playingSound->data;
-
-        const float* const inL = data.getReadPointer(0);
-        const float* const inR = data.getNumChannels() > 1 ? data.getReadPointer(1) : nullptr;
+    if (isVoiceActive())
+        AmiSynthesiser::renderVoiceGroup(bank, &self, 1, outputBuffer, startSample, numSamples);
+}
 
-        float* outL = outputBuffer.getWritePointer(0, startSample);
-        float* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
+bool AmiSamplerVoice::getSlotState(AmiVoiceBank::SlotState_t& slot)
+{
+    AmiSamplerSound* playingSound = static_cast<AmiSamplerSound*> (getCurrentlyPlayingSound().get());
 
-        const int  loopStart = audioProcessor.getLoopStart(currentSample), 
-                   loopEnd    = audioProcessor.getLoopEnd(currentSample),
-                   snh = audioProcessor.getSnH(currentSample);
+    if (playingSound == nullptr || playingSound->numChannels <= 0) return false;
+    if (audioProcessor.isMuted(currentSample)) return false;
 
-        const bool loopEnable = audioProcessor.getLoopEnable(currentSample),
-                   pingPongLoop = audioProcessor.getPingPongLoop(currentSample) && loopEnable,
-                   stereoOn = audioProcessor.paulaStereoOn(currentSample) && numVoices > 1;
+    const float vol = audioProcessor.getChanVol(currentSample),
+                pan = audioProcessor.getChanPan(currentSample);
 
-        const float vol = audioProcessor.getChanVol(currentSample),
-                    vibrato = audioProcessor.getVibrato(),
-                    pan = audioProcessor.getChanPan(currentSample);
+    slot.inL = playingSound->getHeldData(0);
+    slot.inR = playingSound->getHeldData(1);
 
-        fineTune = 1. + audioProcessor.getFineTune(currentSample) / 1200.;
+    slot.length     = playingSound->length;
+    slot.loopStart  = audioProcessor.getLoopStart(currentSample);
+    slot.loopEnd    = audioProcessor.getLoopEnd(currentSample);
+    slot.loopEnable = audioProcessor.getLoopEnable(currentSample);
+    slot.glide      = numVoices <= 1;
 
-        if (sourceSamplePosition <= 0) sourceSamplePosition = 0.0f;
+    const bool pingPong = audioProcessor.getPingPongLoop(currentSample) && slot.loopEnable;
 
-        if(currentSample == audioProcessor.getCurrentSample())
-            audioProcessor.setSamplePos(lgain <= 0 && rgain <= 0 ? 0 : (int) sourceSamplePosition);
+    slot.interpolation = audioProcessor.getInterpolation(currentSample);
 
-        if (audioProcessor.getGlissando(currentSample) <= 1.f) pitchRatio = pitchTarget;
-        
-        while (--numSamples >= 0)
-        {
-            const double totalPitchRatio = (pitchRatio = gliss2pitch()) * vibrato * fineTune * bendRatio;
-            const int pos = (int) std::floor(sourceSamplePosition);
+    // nearest keeps the original point sampling, Paula band-limits its own steps,
+    // and sample and hold is aliasing on purpose
+    slot.numMipLevels = 1;
 
-            const float envelopeValue = adsr.getNextSample();
+    slot.streamed = false;
+    slot.headLength = slot.length;
+    slot.residentStart = slot.residentEnd = 0;
+    slot.loopL = slot.loopR = nullptr;
+    slot.mirrorEnd = 0;
 
-            float l = -getAmi8Bit(inL[pos - (pos % snh)]);
-            float r = (inR != nullptr) ? -getAmi8Bit(inR[pos - (pos % snh)]) : l;
+    if (const AmiSampleStream* stream = playingSound->getStream())
+    {
+        // streamed sounds have no pyramid to read from
+        slot.streamed = true;
+        slot.headLength = stream->getHeadLength();
 
-            l *= lgain * vol * envelopeValue;
-            r *= rgain * vol * envelopeValue;
+        if (const AmiSampleStream::LoopRegion_t* region = stream->getLoopRegion())
+        {
+            // a region loaded for other loop points still holds the sample, but its
+            // reversed half is only played when it mirrors this loop
+            const bool mirrored = pingPong && region->mirrorEnd > 0
+                                   && region->start == slot.loopStart && region->mirrorEnd == slot.loopEnd;
 
-            handleChannelPanning(stereoOn, pan, &l, &r);
+            slot.residentStart = region->start;
+            slot.residentEnd = region->mirrorEnd > 0 && !mirrored ? region->mirrorEnd : region->end;
+            slot.loopL = region->data[0];
+            slot.loopR = region->data[1];
 
-            if (outR != nullptr)
+            if (mirrored)
             {
-                *outL++ += l;
-                *outR++ += r;
-            }
-            else
-            {
-                *outL++ += (l + r) * 0.5f;
+                slot.loopStart = region->start;
+                slot.loopEnd   = region->end;
+                slot.mirrorEnd = region->mirrorEnd;
+                slot.length    = juce::jmax(slot.length, region->end);
             }
+        }
+    }
+    else
+    {
+        if (slot.interpolation != AmiVoiceBank::interpNearest && slot.interpolation != AmiVoiceBank::interpPaula
+             && std::abs(audioProcessor.getSnH(currentSample)) <= 1)
+            playingSound->getMipLevels(slot);
 
-            sourceSamplePosition = handleLoop(loopEnable, pingPongLoop, loopStart, loopEnd, sourceSamplePosition, totalPitchRatio);
-            
-            if (!adsr.isActive() || sourceSamplePosition > playingSound->length)
-            {
-                stopNote(0.0f, false);
-                break;
-            }
+        if (slot.loopEnable) playingSound->getUnrolledLoop(slot, pingPong);
+    }
+
+    // until a copy matching the loop is ready, a loop plays from the sample
+    // itself, a ping-pong one turning round at its ends
+
+    slot.pingPong = pingPong && slot.mirrorEnd == 0;
+
+    slot.volume = vol;
+
+    if (audioProcessor.paulaStereoOn(currentSample) && numVoices > 1)
+    {
+        const float width = pan / 255;
+
+        slot.panLL = slot.panRR = width;
+        slot.panLR = slot.panRL = std::abs(1.f - width);
+    }
+    else
+    {
+        slot.panLL = pan <= 128 ? 1.f : std::abs(pan - 255.f) / 127.f;
+        slot.panRR = pan >= 128 ? 1.f : pan / 127.f;
+        slot.panLR = slot.panRL = 0.f;
+    }
+
+    return true;
+}
+
+void AmiSamplerVoice::beginBlock(const AmiVoiceBank::SlotState_t& slot)
+{
+    int64_t& position = bank.position[lane];
+
+    if (position <= 0) position = 0;
+
+    if (slot.mirrorEnd != mirrorEnd)
+    {
+        // leaving the reversed half of a ping-pong copy: carry on backwards from the same point in the sample
+        if (mirrorEnd > 0 && position >= ((int64_t) mirrorEnd << AmiVoiceBank::phaseBits))
+        {
+            position = juce::jmax((int64_t) 0, ((int64_t) (2 * mirrorEnd) << AmiVoiceBank::phaseBits) - position);
+            bank.playForward[lane] = false;
+        }
+
+        // and going backwards onto a copy: carry on from the same point in its reversed half
+        if (slot.mirrorEnd > 0 && !bank.playForward[lane])
+        {
+            if (position < ((int64_t) slot.mirrorEnd << AmiVoiceBank::phaseBits))
+                position = ((int64_t) (2 * slot.mirrorEnd) << AmiVoiceBank::phaseBits) - position;
+
+            bank.playForward[lane] = true;
         }
     }
+
+    mirrorEnd = slot.mirrorEnd;
+
+    if(currentSample == audioProcessor.getCurrentSample())
+        audioProcessor.setSamplePos(bank.gainL[lane] <= 0 && bank.gainR[lane] <= 0 ? 0 : getSamplePosition());
+
+    // held notes follow the fine tune knob
+    bank.pitchTarget[lane] = AmiVoiceBank::getNoteIncrement(noteSemitones, audioProcessor.getFineTune(currentSample), rateRatio);
+
+    if (audioProcessor.getGlissando(currentSample) <= 1.f) bank.pitch[lane] = bank.pitchTarget[lane];
 }
 
-float AmiSamplerVoice::getAmi8Bit(const float samp) const
+int AmiSamplerVoice::getSamplePosition() const
 {
-    const float amiSamp = samp < 0 ? std::floor(samp * 128.f) / 128.f : std::floor(samp * 127.f) / 127.f;
+    const int pos = (int) (bank.position[lane] >> AmiVoiceBank::phaseBits);
 
-    return amiSamp >= 1 ? 1.f : amiSamp <= -1 ? -1.f : amiSamp;
+    return mirrorEnd > 0 && pos >= mirrorEnd ? 2 * mirrorEnd - 1 - pos : pos;
 }
 
-double AmiSamplerVoice::gliss2pitch() const
+void AmiSamplerVoice::attachStream(const AmiSampleStream* stream)
 {
-    const double nextPitch = pitchRatio + glissRatio;
+    if (stream != nullptr || attachedStream != nullptr)
+        audioProcessor.getDiskStreamer().attach(lane, stream);
 
-    if (numVoices > 1) return pitchTarget;
-    if (pitchRatio <= 0) return pitchTarget;
+    attachedStream = stream;
+}
+
+void AmiSamplerVoice::beginStreamChunk(const int numSamples)
+{
+    AmiDiskStreamer& streamer = audioProcessor.getDiskStreamer();
+
+    // how far this chunk may move either way, with headroom for vibrato and the interpolation taps
+    const double step = AmiVoiceBank::fromPhase(juce::jmax(std::abs(bank.pitch[lane]), std::abs(bank.pitchTarget[lane]))) * bank.bend[lane] * 1.5;
+    const int reach = (int) std::ceil(step * numSamples) + AmiVoiceBank::sincTaps;
 
-    if (slideUp && nextPitch > pitchTarget) return pitchTarget;
-    if (!slideUp && nextPitch < pitchTarget) return pitchTarget;
+    streamer.getWindow(lane, (int) (bank.position[lane] >> AmiVoiceBank::phaseBits) - reach, bank.streamStart[lane], bank.streamEnd[lane]);
 
-    return nextPitch;
+    bank.streamRing[lane][0] = streamer.getRing(lane, 0);
+    bank.streamRing[lane][1] = streamer.getRing(lane, 1);
 }
 
-void AmiSamplerVoice::handleChannelPanning(const bool& stereoOn, const float& pan, float* l, float* r) const
+void AmiSamplerVoice::endStreamChunk()
 {
-    if (stereoOn)
-    {
-        const float width = pan / 255;
+    if (bank.streamMisses[lane] <= 0) return;
 
-        const float widthL = (*l * width) + (*r * std::abs(1.f - width));
-        const float widthR = (*r * width) + (*l * std::abs(1.f - width));
+    audioProcessor.getDiskStreamer().reportUnderruns(bank.streamMisses[lane]);
+    bank.streamMisses[lane] = 0;
+}
 
-        *l = widthL;
-        *r = widthR;
-    }
-    else
+int AmiSamplerVoice::renderEnvelope(float* envelope, const int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
     {
-        const float panL = pan <= 128 ? 1.f : std::abs(pan - 255.f) / 127.f;
-        const float panR = pan >= 128 ? 1.f : pan / 127.f;
-        
-        *l *= panL;
-        *r *= panR;
+        envelope[i] = adsr.getNextSample();
+
+        if (!adsr.isActive()) return i + 1;
     }
-}
 
-double AmiSamplerVoice::handleLoop(const bool enable, const bool pingpong, const int start, const int end, const double pos, const double pitch)
-{
-    const double nextPos = pos + pitch;
-    if(!enable) return nextPos;
-    if(!pingpong) return nextPos < end ? nextPos : (float) start;
-    return (playForward = playForward ? (nextPos < end) : ((pos - pitch) < start)) ? nextPos : pos - pitch;
+    return numSamples + 1;
 }
@@ -36,6 +36,9 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "AmiVoicePool.h"
+#include "AmiSampleStream.h"
+#include "AmiSampleBlock.h"
 
 class AmiSamplerSound    : public juce::SynthesiserSound
 {
@@ -47,8 +50,8 @@ public:
         it in this object.
 
         @param name         a name for the sample
-        @param source       the audio to load. This object can be safely deleted by the
-                            caller after this constructor returns
+        @param source       the audio to play. The sound keeps a reference to the shared
+                            buffer rather than a copy of it
         @param midiNotes    the set of midi keys that this sound should be played on. This
                             is used by the SynthesiserSound::appliesToNote() method
         @param midiNoteForNormalPitch   the midi note at which the sample should be played
@@ -60,7 +63,18 @@ public:
                                         source, in seconds
     */
     AmiSamplerSound (const juce::String& name, int sampleNumber,
-                  juce::AudioSampleBuffer& source, const double& sampleRate,
+                  AmiSampleBuffer::Ptr source, const double& sampleRate,
+                  const juce::BigInteger& midiNotes,
+                  int midiNoteForNormalPitch,
+                  double attackTimeSecs,
+                  double releaseTimeSecs,
+                  AmiAudioProcessor&);
+
+    /** Creates a sound that plays a long sample straight from disk. Only the
+        stream's head and loop region are held in memory.
+    */
+    AmiSamplerSound (const juce::String& name, int sampleNumber,
+                  AmiSampleStream::Ptr stream, const double& sampleRate,
                   const juce::BigInteger& midiNotes,
                   int midiNoteForNormalPitch,
                   double attackTimeSecs,
@@ -77,7 +91,79 @@ public:
     /** Returns the audio sample data.
         This could return nullptr if there was a problem loading the data.
     */
-    juce::AudioBuffer<float>* getAudioData() const noexcept       { return data.get(); }
+    const juce::AudioBuffer<float>* getAudioData() const noexcept { return data != nullptr ? &data->getBuffer() : nullptr; }
+
+    /** Returns the sample pre-quantized to Paula's signed 8-bit range, or nullptr
+        if the channel doesn't exist. Negative values are steps of 1/128, positive
+        values steps of 1/127, matching the original per-sample conversion.
+    */
+    const int8_t* getAmi8BitData(const int channel) const noexcept
+    {
+        return channel < numChannels ? ami8BitData.getRun(channel) : nullptr;
+    }
+
+    /** Converts one float sample to the 8-bit value Paula would play. */
+    static int8_t toAmi8Bit(const float samp);
+
+    //==============================================================================
+    /** Returns the 8-bit data as seen through the current "SAMP N HOLD" decimator,
+        so the voices can read it contiguously without a modulo per sample.
+    */
+    const int8_t* getHeldData(const int channel) const noexcept
+    {
+        if (stream != nullptr) return stream->getHead(channel);
+
+        return channel < numChannels ? currentHoldView.load(std::memory_order_acquire)->data[channel] : nullptr;
+    }
+
+    /** The file this sound streams from, or nullptr if it is held in memory. */
+    AmiSampleStream* getStream() const noexcept { return stream.get(); }
+
+    /** Switches the decimated view to the given hold length, building it the first
+        time it is asked for. Call this from the message thread; the render thread
+        only ever sees a complete view through an atomic swap.
+    */
+    void setSampleAndHold(const int snh);
+
+    //==============================================================================
+    /** Fills in the octave pyramid for the render kernel, or just level 0 if it
+        hasn't been built yet, in which case it is requested. Render thread.
+    */
+    void getMipLevels(AmiVoiceBank::SlotState_t& slot);
+
+    /** True once, after the render thread first asked for the pyramid; the caller
+        then owns building it.
+    */
+    bool claimPyramidRequest();
+
+    /** Builds the pyramid. Slow: call it from a background thread. */
+    void buildPyramid();
+
+    //==============================================================================
+    /** Points a looping slot at the unrolled copy of its loop, which the kernel
+        plays as a forward loop. Returns false, leaving the slot alone, unless
+        there is one for the slot's loop points, this kind of loop and the
+        current hold view. Render thread.
+    */
+    bool getUnrolledLoop(AmiVoiceBank::SlotState_t& slot, const bool pingPong) const;
+
+    /** Message thread: true once, when the unrolled copy doesn't match this loop
+        or the current hold view and no build is running; the caller then runs
+        unrollLoop(). Loops that don't fit inside the sample are never unrolled.
+    */
+    bool claimLoopUnroll(const int loopStart, const int loopEnd, const bool pingPong);
+
+    /** Background thread: copies the sample up to the loop end, followed by the
+        loop reversed for a ping-pong one, for every level there is, to be picked
+        up by publishUnrolledLoop(). The guard after each copy holds where the
+        loop carries on from.
+    */
+    void unrollLoop(const int loopStart, const int loopEnd, const bool pingPong);
+
+    /** Message thread: swaps in a newly built unrolled loop and returns the one
+        it replaces, whose reference the caller must retire.
+    */
+    juce::ReferenceCountedObject* publishUnrolledLoop();
 
     //==============================================================================
     /** Changes the parameters of the ADSR envelope which will be applied to the sample. */
@@ -100,10 +186,73 @@ private:
     friend class AmiSamplerVoice;
 
     juce::String name;
-    std::unique_ptr<juce::AudioBuffer<float>> data;
+    AmiSampleBuffer::Ptr data;
+    AmiSampleStream::Ptr stream;
+    AmiSampleBlock ami8BitData;
+
+    static constexpr int maxHold = 16;
+
+    typedef struct HoldView_t
+    {
+    public:
+
+        AmiSampleBlock storage;
+        const int8_t* data[2];
+
+    } HoldView_t;
+
+    // views are cached for the lifetime of the sound, so one that the render thread
+    // may still be reading is never freed from under it
+    std::unique_ptr<HoldView_t> holdViews[maxHold];
+    std::atomic<HoldView_t*> currentHoldView { nullptr };
+
+    typedef struct MipPyramid_t
+    {
+    public:
+
+        AmiSampleBlock storage;
+
+        const int8_t* data[2][AmiVoiceBank::maxMipLevels];
+        int length[AmiVoiceBank::maxMipLevels];
+        int numLevels;
+
+    } MipPyramid_t;
+
+    enum { pyramidNone, pyramidRequested, pyramidBuilding, pyramidBuilt };
+
+    std::unique_ptr<MipPyramid_t> pyramidStorage;
+    std::atomic<MipPyramid_t*> pyramid { nullptr };
+    std::atomic<int> pyramidState { pyramidNone };
+
+    typedef struct UnrolledLoop_t : public juce::ReferenceCountedObject
+    {
+    public:
+
+        // what it was built from; level 0 holds the sample up to loopEnd, then for
+        // a ping-pong loop [loopStart, loopEnd) backwards
+        int loopStart = 0, loopEnd = 0;
+        bool pingPong = false;
+        const HoldView_t* holdView = nullptr;
+        const MipPyramid_t* levels = nullptr;
+
+        AmiSampleBlock storage;
+
+        const int8_t* data[2][AmiVoiceBank::maxMipLevels];
+        int length[AmiVoiceBank::maxMipLevels];
+        int numLevels = 0;
+
+    } UnrolledLoop_t;
+
+    std::atomic<UnrolledLoop_t*> unrolledLoop { nullptr }, pendingUnrolledLoop { nullptr };
+    std::atomic<bool> unrolling { false };
+
+    int requestedUnrollStart = -1, requestedUnrollEnd = -1;
+    bool requestedUnrollPingPong = false;
+    const HoldView_t* requestedUnrollView = nullptr;
+    const MipPyramid_t* requestedUnrollLevels = nullptr;
     double sourceSampleRate = 0.0;
     juce::BigInteger midiNotes;
-    int length = 0, midiRootNote = 0;
+    int length = 0, midiRootNote = 0, numChannels = 0;
 
     int currentSample = 0;
 
@@ -131,8 +280,8 @@ class AmiSamplerVoice : public juce::SynthesiserVoice,
 {
 public:
     //==============================================================================
-    /** Creates a SamplerVoice. */
-    AmiSamplerVoice(AmiAudioProcessor&);
+    /** Creates a SamplerVoice that keeps its playback state in one lane of the pool's voice bank. */
+    AmiSamplerVoice(AmiAudioProcessor&, AmiVoicePool&, const int lane);
 
     /** Destructor. */
     ~AmiSamplerVoice() override;
@@ -151,17 +300,39 @@ public:
 
 private:
     //==============================================================================
-    float getAmi8Bit(const float samp) const;
-    double gliss2pitch() const;
-    void handleChannelPanning(const bool& stereoOn, const float& pan, float* l, float* r) const;
-    double handleLoop(const bool enable, const bool pingpong, const int start, const int end, const double pos, const double pitch);
+    friend class AmiSynthesiser;
+    friend class AmiVoicePool;
 
-    bool releasedNote = true, slideUp = false, playForward = true;
-    double pitchRatio = 0., glissRatio = 0., pitchTarget = 0., fineTune = 0., bendRatio = 0.f;
+    int  getLane() const { return lane; }
+    void resetNoteState();
+    bool getSlotState(AmiVoiceBank::SlotState_t&);
+    const float* getVibrato() const { return audioProcessor.getVibratoBuffer(); }
+    void beginBlock(const AmiVoiceBank::SlotState_t&);
+
+    /** The lane's position in the sample, folding the reversed half of a ping-pong loop back. */
+    int  getSamplePosition() const;
+    int  renderEnvelope(float* envelope, const int numSamples);
+
+    /** Streamed sounds: fetches the lane's ring window before a chunk, and reports what it missed after. */
+    void attachStream(const AmiSampleStream* stream);
+    void beginStreamChunk(const int numSamples);
+    void endStreamChunk();
+
+    bool releasedNote = true;
     int currentSample = 0, numVoices = 8;
-    
-    double sourceSamplePosition = 0.0;
-    float lgain = 0, rgain = 0;
+
+    // the playing note, so its pitch can follow the fine tune
+    int noteSemitones = 0;
+    double rateRatio = 1.0;
+
+    // the mirrorEnd of the slot last rendered, to fold positions back when it changes
+    int mirrorEnd = 0;
+
+    const AmiSampleStream* attachedStream = nullptr;
+
+    AmiVoicePool& pool;
+    AmiVoiceBank& bank;
+    const int lane;
 
     juce::ADSR adsr;
 
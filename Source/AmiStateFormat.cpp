@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+    AmiStateFormat.cpp
+    Created: 17 Oct 2026 9:15:27pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiStateFormat.h"
+
+bool AmiStateFormat::isBinaryState(const void* data, const int sizeInBytes)
+{
+    if (data == nullptr || sizeInBytes < 12) return false;
+
+    return (int) juce::ByteOrder::littleEndianInt(data) == magic;
+}
+
+void AmiStateFormat::encodeChunk(const float* samples, const int numSamples, SampleChunk_t& dest, const bool compress)
+{
+    dest.numSamples = juce::jmax(0, numSamples);
+    dest.compressed = false;
+
+    if (dest.numSamples == 0)
+    {
+        dest.payload.reset();
+        return;
+    }
+
+    dest.format = chooseFormat(samples, numSamples);
+    encodeSamples(samples, numSamples, dest.format, dest.payload);
+
+    if (!compress) return;
+
+    juce::MemoryBlock packed;
+
+    {
+        juce::MemoryOutputStream packedOut(packed, false);
+
+        // lowest level: most of the gain on 8-bit audio for a fraction of the time
+        juce::GZIPCompressorOutputStream zipper(packedOut, 1);
+        zipper.write(dest.payload.getData(), dest.payload.getSize());
+    }
+
+    if (packed.getSize() < dest.payload.getSize())
+    {
+        dest.payload.swapWith(packed);
+        dest.compressed = true;
+    }
+}
+
+bool AmiStateFormat::decodeChunk(const SampleChunk_t& chunk, juce::AudioBuffer<float>& dest)
+{
+    if (chunk.numSamples <= 0) return false;
+
+    dest.setSize(1, chunk.numSamples);
+
+    if (!chunk.compressed)
+        return decodeSamples(chunk.payload.getData(), chunk.payload.getSize(), chunk.format, dest.getWritePointer(0), chunk.numSamples);
+
+    juce::MemoryInputStream packedIn(chunk.payload, false);
+    juce::GZIPDecompressorInputStream unzipper(packedIn);
+    juce::MemoryBlock payload;
+
+    unzipper.readIntoMemoryBlock(payload);
+
+    return decodeSamples(payload.getData(), payload.getSize(), chunk.format, dest.getWritePointer(0), chunk.numSamples);
+}
+
+void AmiStateFormat::write(const juce::ValueTree& params, const SampleChunk_t* const* chunks, const int numSlots,
+                           juce::MemoryBlock& destData)
+{
+    juce::MemoryOutputStream out(destData, false);
+    juce::MemoryBlock paramData;
+
+    int numChunks = 0;
+
+    for (int i = 0; i < numSlots; i++)
+        if (chunks[i] != nullptr && chunks[i]->numSamples > 0) numChunks++;
+
+    {
+        juce::MemoryOutputStream paramOut(paramData, false);
+        params.writeToStream(paramOut);
+    }
+
+    out.writeInt(magic);
+    out.writeInt(version);
+    out.writeInt(numChunks);
+
+    out.writeInt((int) paramData.getSize());
+    out.write(paramData.getData(), paramData.getSize());
+
+    for (int i = 0; i < numSlots; i++)
+    {
+        const SampleChunk_t* chunk = chunks[i];
+
+        if (chunk == nullptr || chunk->numSamples <= 0) continue;
+
+        out.writeByte((char) i);
+        out.writeByte((char) chunk->format);
+        out.writeByte((char) (chunk->compressed ? 1 : 0));
+        out.writeInt(chunk->numSamples);
+        out.writeInt((int) chunk->payload.getSize());
+        out.write(chunk->payload.getData(), chunk->payload.getSize());
+    }
+}
+
+bool AmiStateFormat::read(const void* data, const int sizeInBytes, juce::ValueTree& params,
+                          SampleChunk_t* chunks, const int numSlots)
+{
+    if (!isBinaryState(data, sizeInBytes)) return false;
+
+    juce::MemoryInputStream in(data, (size_t) sizeInBytes, false);
+
+    in.readInt();
+
+    if (in.readInt() > version) return false;
+
+    const int numChunks = in.readInt();
+    const int paramSize = in.readInt();
+
+    if (paramSize <= 0 || paramSize > in.getNumBytesRemaining()) return false;
+
+    juce::MemoryBlock paramData;
+    in.readIntoMemoryBlock(paramData, paramSize);
+
+    params = juce::ValueTree::readFromData(paramData.getData(), paramData.getSize());
+
+    if (!params.isValid()) return false;
+
+    for (int i = 0; i < numSlots; i++)
+    {
+        chunks[i].numSamples = 0;
+        chunks[i].payload.reset();
+    }
+
+    for (int n = 0; n < numChunks; n++)
+    {
+        const int slot = (int) (uint8_t) in.readByte();
+        const SampleFormat format = (SampleFormat) in.readByte();
+        const bool compressed = in.readByte() != 0;
+        const int numSamples = in.readInt();
+        const int chunkSize = in.readInt();
+
+        if (numSamples <= 0 || chunkSize < 0 || chunkSize > in.getNumBytesRemaining()) return false;
+
+        // a slot we don't have (a newer build with more samplers); skip it
+        if (slot >= numSlots)
+        {
+            in.skipNextBytes(chunkSize);
+            continue;
+        }
+
+        chunks[slot].format = format;
+        chunks[slot].compressed = compressed;
+        chunks[slot].numSamples = numSamples;
+
+        chunks[slot].payload.reset();
+        in.readIntoMemoryBlock(chunks[slot].payload, chunkSize);
+    }
+
+    return true;
+}
+
+AmiStateFormat::SampleFormat AmiStateFormat::chooseFormat(const float* samples, const int numSamples)
+{
+    bool fits8 = true, fits16 = true;
+
+    for (int i = 0; i < numSamples && fits16; i++)
+    {
+        const float s8 = samples[i] * 128.f, s16 = samples[i] * 32768.f;
+
+        fits8  = fits8 && s8 == std::floor(s8) && s8 >= -128.f && s8 <= 127.f;
+        fits16 = s16 == std::floor(s16) && s16 >= -32768.f && s16 <= 32767.f;
+    }
+
+    return fits8 ? int8Samples : fits16 ? int16Samples : float32Samples;
+}
+
+void AmiStateFormat::encodeSamples(const float* samples, const int numSamples, const SampleFormat format, juce::MemoryBlock& dest)
+{
+    dest.setSize((size_t) numSamples * (size_t) format);
+
+    if (format == int8Samples)
+    {
+        int8_t* out = static_cast<int8_t*>(dest.getData());
+
+        for (int i = 0; i < numSamples; i++)
+            out[i] = (int8_t) (samples[i] * 128.f);
+    }
+    else if (format == int16Samples)
+    {
+        uint16_t* out = static_cast<uint16_t*>(dest.getData());
+
+        for (int i = 0; i < numSamples; i++)
+            out[i] = juce::ByteOrder::swapIfBigEndian((uint16_t) (int16_t) (samples[i] * 32768.f));
+    }
+    else
+    {
+        uint32_t* out = static_cast<uint32_t*>(dest.getData());
+
+        for (int i = 0; i < numSamples; i++)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, samples + i, sizeof(bits));
+
+            out[i] = juce::ByteOrder::swapIfBigEndian(bits);
+        }
+    }
+}
+
+bool AmiStateFormat::decodeSamples(const void* payload, const size_t payloadSize, const SampleFormat format,
+                                   float* samples, const int numSamples)
+{
+    if (format != int8Samples && format != int16Samples && format != float32Samples) return false;
+
+    if (payloadSize != (size_t) numSamples * (size_t) format) return false;
+
+    if (format == int8Samples)
+    {
+        const int8_t* in = static_cast<const int8_t*>(payload);
+
+        for (int i = 0; i < numSamples; i++)
+            samples[i] = (float) in[i] / 128.f;
+    }
+    else if (format == int16Samples)
+    {
+        const uint16_t* in = static_cast<const uint16_t*>(payload);
+
+        for (int i = 0; i < numSamples; i++)
+            samples[i] = (float) (int16_t) juce::ByteOrder::swapIfBigEndian(in[i]) / 32768.f;
+    }
+    else
+    {
+        const uint32_t* in = static_cast<const uint32_t*>(payload);
+
+        for (int i = 0; i < numSamples; i++)
+        {
+            const uint32_t bits = juce::ByteOrder::swapIfBigEndian(in[i]);
+            std::memcpy(samples + i, &bits, sizeof(bits));
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    AmiStateFormat.h
+    Created: 17 Oct 2026 9:15:27pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Binary plugin state ////
+
+  Layout (all integers little-endian):
+
+      'AmiS' magic, format version, number of sample chunks
+      parameter block : size, then the APVTS tree written with ValueTree::writeToStream
+      sample chunks   : slot, sample format, compressed flag, length in samples,
+                        payload size, then the payload
+
+  Samples are stored as int8 when they came from an 8-bit source, int16 when
+  they fit 16 bits exactly, and as raw floats otherwise, so a restore always
+  gives back the exact buffer that was saved. A payload is zlib compressed
+  only when that makes it smaller.
+
+  States saved before this format existed are XML with the samples base64
+  encoded in the tree; isBinaryState() tells the two apart.
+
+  ==============================================================================
+*/
+
+class AmiStateFormat
+{
+public:
+
+    static constexpr int version = 1;
+
+    enum SampleFormat
+    {
+        int8Samples    = 1,
+        int16Samples   = 2,
+        float32Samples = 4
+    };
+
+    typedef struct SampleChunk_t
+    {
+    public:
+
+        SampleFormat format = int8Samples;
+        bool compressed = false;
+        int numSamples = 0;                 // 0 for an empty slot
+
+        juce::MemoryBlock payload;
+
+    } SampleChunk_t;
+
+    static bool isBinaryState(const void* data, const int sizeInBytes);
+
+    /** Packs a slot's samples into the smallest lossless chunk. */
+    static void encodeChunk(const float* samples, const int numSamples, SampleChunk_t& dest, const bool compress = true);
+
+    /** Unpacks a chunk into a one channel buffer. */
+    static bool decodeChunk(const SampleChunk_t& chunk, juce::AudioBuffer<float>& dest);
+
+    /** Writes the parameter tree and every non-empty chunk. chunks holds one
+        (possibly nullptr) entry per slot.
+    */
+    static void write(const juce::ValueTree& params, const SampleChunk_t* const* chunks, const int numSlots,
+                      juce::MemoryBlock& destData);
+
+    /** Reads a binary state. Slots without a chunk come back with numSamples 0. */
+    static bool read(const void* data, const int sizeInBytes, juce::ValueTree& params,
+                     SampleChunk_t* chunks, const int numSlots);
+
+private:
+
+    static constexpr int magic = 0x53696d41;  // "AmiS"
+
+    static SampleFormat chooseFormat(const float* samples, const int numSamples);
+
+    static void encodeSamples(const float* samples, const int numSamples, const SampleFormat format, juce::MemoryBlock& dest);
+    static bool decodeSamples(const void* payload, const size_t payloadSize, const SampleFormat format,
+                              float* samples, const int numSamples);
+
+    AmiStateFormat() = delete;
+};
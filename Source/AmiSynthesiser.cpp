@@ -0,0 +1,280 @@
+/*
+  ==============================================================================
+
+    AmiSynthesiser.cpp
+    Created: 17 Oct 2026 10:48:03am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiSynthesiser.h"
+#include "AmiSamplerSound.h"
+
+AmiSynthesiser::AmiSynthesiser() {}
+
+AmiSynthesiser::~AmiSynthesiser()
+{
+    // by now the processor has swapped every sound out through its reclaimer
+    jassert(currentSound.load() == nullptr);
+}
+
+juce::SynthesiserSound* AmiSynthesiser::swapSound(juce::SynthesiserSound* newSound)
+{
+    if (newSound != nullptr) newSound->incReferenceCount();
+
+    return currentSound.exchange(newSound, std::memory_order_acq_rel);
+}
+
+void AmiSynthesiser::noteOn(const int midiChannel, const int midiNoteNumber, const float velocity)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (pool == nullptr) return;
+
+    juce::SynthesiserSound* sound = currentSound.load(std::memory_order_acquire);
+
+    if (sound != nullptr && sound->appliesToNote(midiNoteNumber) && sound->appliesToChannel(midiChannel))
+    {
+        AmiSamplerVoice* slotVoices[AmiVoicePool::maxVoices];
+        const int numVoices = pool->getSlotVoices(slot, slotVoices);
+
+        // If hitting a note that's still ringing, stop it first (it could be
+        // still playing because of the sustain pedal).
+        for (int n = 0; n < numVoices; n++)
+            if (slotVoices[n]->getCurrentlyPlayingNote() == midiNoteNumber && slotVoices[n]->isPlayingChannel(midiChannel))
+                slotVoices[n]->stopNote(1.0f, true);
+
+        if (AmiSamplerVoice* voice = pool->claimVoice(slot, voiceLimit))
+        {
+            startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+            pool->voiceStarted(*voice, slot);
+        }
+    }
+}
+
+void AmiSynthesiser::noteOff(const int midiChannel, const int midiNoteNumber, const float velocity, const bool allowTailOff)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (pool == nullptr) return;
+
+    AmiSamplerVoice* slotVoices[AmiVoicePool::maxVoices];
+    const int numVoices = pool->getSlotVoices(slot, slotVoices);
+
+    for (int n = 0; n < numVoices; n++)
+    {
+        AmiSamplerVoice* voice = slotVoices[n];
+
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel))
+        {
+            if (juce::SynthesiserSound* sound = voice->getCurrentlyPlayingSound().get())
+            {
+                if (sound->appliesToNote(midiNoteNumber) && sound->appliesToChannel(midiChannel))
+                {
+                    voice->setKeyDown(false);
+
+                    if (!(voice->isSustainPedalDown() || voice->isSostenutoPedalDown()))
+                        voice->stopNote(velocity, allowTailOff);
+                }
+            }
+        }
+    }
+}
+
+void AmiSynthesiser::allNotesOff(const int midiChannel, const bool allowTailOff)
+{
+    const juce::ScopedLock sl(lock);
+
+    juce::Synthesiser::allNotesOff(midiChannel, allowTailOff);
+
+    if (pool == nullptr) return;
+
+    AmiSamplerVoice* slotVoices[AmiVoicePool::maxVoices];
+    const int numVoices = pool->getSlotVoices(slot, slotVoices);
+
+    for (int n = 0; n < numVoices; n++)
+        if (midiChannel <= 0 || slotVoices[n]->isPlayingChannel(midiChannel))
+            slotVoices[n]->stopNote(1.0f, allowTailOff);
+}
+
+void AmiSynthesiser::handlePitchWheel(const int midiChannel, const int wheelValue)
+{
+    const juce::ScopedLock sl(lock);
+
+    // new notes on this channel start from the wheel's latest position
+    if (midiChannel > 0 && midiChannel <= 16)
+        lastPitchWheelValues[midiChannel - 1] = wheelValue;
+
+    if (pool == nullptr) return;
+
+    AmiSamplerVoice* slotVoices[AmiVoicePool::maxVoices];
+    const int numVoices = pool->getSlotVoices(slot, slotVoices);
+
+    for (int n = 0; n < numVoices; n++)
+        if (midiChannel <= 0 || slotVoices[n]->isPlayingChannel(midiChannel))
+            slotVoices[n]->pitchWheelMoved(wheelValue);
+}
+
+void AmiSynthesiser::handleSustainPedal(const int midiChannel, const bool isDown)
+{
+    const juce::ScopedLock sl(lock);
+
+    // keeps the base class's per-channel pedal state up to date for startVoice()
+    juce::Synthesiser::handleSustainPedal(midiChannel, isDown);
+
+    if (pool == nullptr) return;
+
+    AmiSamplerVoice* slotVoices[AmiVoicePool::maxVoices];
+    const int numVoices = pool->getSlotVoices(slot, slotVoices);
+
+    for (int n = 0; n < numVoices; n++)
+    {
+        AmiSamplerVoice* voice = slotVoices[n];
+
+        if (!voice->isPlayingChannel(midiChannel)) continue;
+
+        if (isDown)
+        {
+            if (voice->isKeyDown()) voice->setSustainPedalDown(true);
+        }
+        else if (voice->isSustainPedalDown())
+        {
+            voice->setSustainPedalDown(false);
+
+            if (!(voice->isKeyDown() || voice->isSostenutoPedalDown()))
+                voice->stopNote(1.0f, true);
+        }
+    }
+}
+
+void AmiSynthesiser::handleSostenutoPedal(const int midiChannel, const bool isDown)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (pool == nullptr) return;
+
+    AmiSamplerVoice* slotVoices[AmiVoicePool::maxVoices];
+    const int numVoices = pool->getSlotVoices(slot, slotVoices);
+
+    for (int n = 0; n < numVoices; n++)
+    {
+        AmiSamplerVoice* voice = slotVoices[n];
+
+        if (!voice->isPlayingChannel(midiChannel)) continue;
+
+        // only the notes held when the pedal goes down are latched
+        if (isDown)
+        {
+            if (voice->isKeyDown()) voice->setSostenutoPedalDown(true);
+        }
+        else if (voice->isSostenutoPedalDown())
+        {
+            voice->setSostenutoPedalDown(false);
+
+            if (!(voice->isKeyDown() || voice->isSustainPedalDown()))
+                voice->stopNote(1.0f, true);
+        }
+    }
+}
+
+void AmiSynthesiser::renderSubBlock(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    const juce::ScopedLock sl(lock);
+
+    renderVoices(outputAudio, startSample, numSamples);
+}
+
+void AmiSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    AmiSamplerVoice* active[AmiVoicePool::maxVoices];
+
+    if (pool == nullptr) return;
+
+    int numActive = pool->getSlotVoices(slot, active);
+
+    // voices still tailing off a replaced sound are rendered as their own group
+
+    while (numActive > 0)
+    {
+        AmiSamplerVoice* group[AmiVoicePool::maxVoices];
+        int numInGroup = 0, numRemaining = 0;
+
+        const juce::SynthesiserSound* sound = active[0]->getCurrentlyPlayingSound().get();
+
+        for (int n = 0; n < numActive; n++)
+        {
+            if (active[n]->getCurrentlyPlayingSound().get() == sound)
+                group[numInGroup++] = active[n];
+            else
+                active[numRemaining++] = active[n];
+        }
+
+        numActive = numRemaining;
+
+        renderVoiceGroup(pool->getVoiceBank(), group, numInGroup, outputAudio, startSample, numSamples);
+    }
+}
+
+void AmiSynthesiser::renderVoiceGroup(AmiVoiceBank& bank, AmiSamplerVoice* const* group, const int numInGroup,
+                                      juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    constexpr int laneWidth = AmiVoiceBank::laneWidth, chunkSize = AmiVoiceBank::chunkSize;
+
+    AmiVoiceBank::SlotState_t slot;
+
+    AmiSamplerVoice* playing[AmiVoiceBank::maxVoices];
+    int numPlaying = 0;
+
+    float envelope[laneWidth][chunkSize];
+    int lanes[laneWidth], envLength[laneWidth];
+    bool finished[laneWidth];
+
+    if (numInGroup <= 0 || !group[0]->getSlotState(slot)) return;
+
+    for (int n = 0; n < numInGroup; n++)
+    {
+        group[n]->beginBlock(slot);
+        playing[numPlaying++] = group[n];
+    }
+
+    const float* vibrato = group[0]->getVibrato() + startSample;
+
+    float* outL = outputAudio.getWritePointer(0, startSample);
+    float* outR = outputAudio.getNumChannels() > 1 ? outputAudio.getWritePointer(1, startSample) : nullptr;
+
+    for (int offset = 0; offset < numSamples && numPlaying > 0; offset += chunkSize)
+    {
+        const int numInChunk = juce::jmin(chunkSize, numSamples - offset);
+        int numStillPlaying = 0;
+
+        for (int first = 0; first < numPlaying; first += laneWidth)
+        {
+            const int numLanes = juce::jmin(laneWidth, numPlaying - first);
+
+            for (int k = 0; k < numLanes; k++)
+            {
+                lanes[k] = playing[first + k]->getLane();
+                envLength[k] = playing[first + k]->renderEnvelope(envelope[k], numInChunk);
+
+                if (slot.streamed) playing[first + k]->beginStreamChunk(numInChunk);
+            }
+
+            bank.renderGroup(lanes, numLanes, slot, envelope, envLength, vibrato + offset,
+                             outL + offset, outR != nullptr ? outR + offset : nullptr, numInChunk, finished);
+
+            for (int k = 0; k < numLanes; k++)
+            {
+                if (slot.streamed) playing[first + k]->endStreamChunk();
+
+                if (finished[k])
+                    playing[first + k]->stopNote(0.0f, false);
+                else
+                    playing[numStillPlaying++] = playing[first + k];
+            }
+        }
+
+        numPlaying = numStillPlaying;
+    }
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    AmiSynthesiser.h
+    Created: 17 Oct 2026 10:48:03am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AmiVoicePool.h"
+
+class AmiSamplerVoice;
+
+//==============================================================================
+/**
+    A Synthesiser for one sampler slot that borrows its voices from a shared
+    AmiVoicePool instead of owning them.
+
+    The note and pedal handlers below mirror juce::Synthesiser's, but walk the
+    slot's voices in the pool, and the slot's sound is published through an
+    atomic pointer rather than the lock-guarded sounds array. Instead of asking each voice to render itself,
+    renderVoices() groups them by sound and hands each group to the bank's lane
+    kernel.
+*/
+class AmiSynthesiser : public juce::Synthesiser
+{
+public:
+    AmiSynthesiser();
+    ~AmiSynthesiser() override;
+
+    /** Attaches the slot to the pool it plays its voices from. */
+    void setVoicePool(AmiVoicePool* voicePool, const int slotNumber) { pool = voicePool; slot = slotNumber; }
+
+    /** Publishes a new sound for the slot (or none) with an atomic swap, taking a
+        reference to it. Returns the previous sound still holding the slot's
+        reference, which the caller must hand to an AmiSampleReclaimer rather
+        than release. Message thread only.
+    */
+    juce::SynthesiserSound* swapSound(juce::SynthesiserSound* newSound);
+
+    /** The sound currently published for the slot. On the message thread this
+        stays valid until the next swapSound().
+    */
+    juce::SynthesiserSound* getCurrentSound() const { return currentSound.load(std::memory_order_acquire); }
+
+    /** The most voices this slot may hold at once (1 makes it mono, with glide). */
+    void setVoiceLimit(const int limit) { voiceLimit = juce::jlimit(1, 8, limit); }
+    int  getVoiceLimit() const { return voiceLimit; }
+
+    //==============================================================================
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+    void allNotesOff(int midiChannel, bool allowTailOff) override;
+
+    void handlePitchWheel(int midiChannel, int wheelValue) override;
+    void handleSustainPedal(int midiChannel, bool isDown) override;
+    void handleSostenutoPedal(int midiChannel, bool isDown) override;
+
+    /** Renders the slot's voices for one stretch of the block with no MIDI in it.
+        AmiMidiDispatcher calls this between the slot's own events.
+    */
+    void renderSubBlock(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+
+    /** Renders a set of voices that are all playing the same sound through the bank they share. */
+    static void renderVoiceGroup(AmiVoiceBank& bank, AmiSamplerVoice* const* group, const int numInGroup,
+                                 juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples);
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    using juce::Synthesiser::renderVoices;
+
+private:
+    std::atomic<juce::SynthesiserSound*> currentSound { nullptr };
+
+    AmiVoicePool* pool = nullptr;
+    int slot = 0;
+    std::atomic<int> voiceLimit { 8 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiSynthesiser)
+};
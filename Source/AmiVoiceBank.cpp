@@ -0,0 +1,695 @@
+/*
+  ==============================================================================
+
+    AmiVoiceBank.cpp
+    Created: 17 Oct 2026 10:12:40am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiVoiceBank.h"
+
+#include <complex>
+
+// in-place radix-2 FFT, only used to build the BLEP table
+static void fft(std::complex<double>* x, const int size, const bool inverse)
+{
+    for (int i = 1, j = 0; i < size; i++)
+    {
+        int bit = size >> 1;
+
+        for (; j & bit; bit >>= 1) j ^= bit;
+
+        j ^= bit;
+
+        if (i < j) std::swap(x[i], x[j]);
+    }
+
+    for (int len = 2; len <= size; len <<= 1)
+    {
+        const double angle = (inverse ? 2.0 : -2.0) * juce::MathConstants<double>::pi / len;
+        const std::complex<double> w(std::cos(angle), std::sin(angle));
+
+        for (int i = 0; i < size; i += len)
+        {
+            std::complex<double> wn(1.0);
+
+            for (int k = 0; k < len / 2; k++, wn *= w)
+            {
+                const std::complex<double> a = x[i + k], b = x[i + k + len / 2] * wn;
+
+                x[i + k] = a + b;
+                x[i + k + len / 2] = a - b;
+            }
+        }
+    }
+
+    if (inverse)
+        for (int i = 0; i < size; i++) x[i] /= (double) size;
+}
+
+AmiVoiceBank::AmiVoiceBank()
+{
+    for (int lane = 0; lane < maxVoices; lane++)
+        resetLane(lane);
+
+    // built here rather than on the audio thread's first Paula note
+    getBlepTable();
+}
+
+AmiVoiceBank::~AmiVoiceBank() {}
+
+void AmiVoiceBank::resetLane(const int lane)
+{
+    jassert(lane >= 0 && lane < maxVoices);
+
+    position[lane] = pitch[lane] = pitchTarget[lane] = glissStep[lane] = 0;
+    bend[lane] = 1.0;
+
+    gainL[lane] = gainR[lane] = 0.f;
+
+    playForward[lane] = true;
+    slideUp[lane] = false;
+
+    streamRing[lane][0] = streamRing[lane][1] = nullptr;
+    streamStart[lane] = streamEnd[lane] = streamMisses[lane] = 0;
+
+    clearBlep(lane);
+}
+
+void AmiVoiceBank::clearBlep(const int lane)
+{
+    jassert(lane >= 0 && lane < maxVoices);
+
+    std::fill(blepResidual[lane][0], blepResidual[lane][0] + 2 * blepLength, 0.f);
+
+    blepLast[lane][0] = blepLast[lane][1] = 0.f;
+    blepIndex[lane] = 0;
+    blepWrapped[lane] = false;
+}
+
+int64_t AmiVoiceBank::getNoteIncrement(const int semitones, const float fineTune, const double rateRatio)
+{
+    static const struct Table_t
+    {
+        Table_t()
+        {
+            // one octave of semitones per fine tune step, the others being shifts of it;
+            // fine tune keeps the linear cents approximation the voices have always used
+            for (int f = 0; f <= 2 * fineTuneSteps; f++)
+            {
+                const double cents = (double) (f - fineTuneSteps) * maxFineTune / fineTuneSteps;
+
+                for (int n = 0; n < 12; n++)
+                    values[f][n] = toPhase(std::pow(2.0, n / 12.0) * (1.0 + cents / 1200.0));
+            }
+        }
+
+        int64_t values[2 * fineTuneSteps + 1][12];
+
+    } table;
+
+    const int step = juce::jlimit(0, 2 * fineTuneSteps, juce::roundToInt(fineTune * fineTuneSteps / maxFineTune) + fineTuneSteps);
+
+    const int octave = (semitones >= 0 ? semitones : semitones - 11) / 12;
+    const int64_t increment = table.values[step][semitones - 12 * octave];
+
+    return (int64_t) ((double) (octave >= 0 ? increment << octave : increment >> -octave) * rateRatio);
+}
+
+const float* AmiVoiceBank::getAmi8BitTable()
+{
+    static const struct Table_t
+    {
+        Table_t()
+        {
+            for (int i = 0; i < 256; i++)
+                values[i] = fromAmi8Bit((int8_t) (i - 128));
+        }
+
+        float values[256];
+
+    } table;
+
+    return table.values + 128;
+}
+
+const float* AmiVoiceBank::getSincTable()
+{
+    static const struct Table_t
+    {
+        Table_t()
+        {
+            constexpr double pi = juce::MathConstants<double>::pi;
+            constexpr double halfWidth = sincTaps / 2;
+
+            for (int p = 0; p < sincPhases; p++)
+            {
+                const double frac = (double) p / sincPhases;
+                double sum = 0.0;
+
+                for (int t = 0; t < sincTaps; t++)
+                {
+                    // distance of tap t (sample idx - 3 + t) from the read position
+                    const double x = (double) (t - (sincTaps / 2 - 1)) - frac;
+                    const double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+                    const double window = 0.42 + 0.5 * std::cos(pi * x / halfWidth) + 0.08 * std::cos(2.0 * pi * x / halfWidth);
+
+                    coeffs[p][t] = sinc * window;
+                    sum += coeffs[p][t];
+                }
+
+                for (int t = 0; t < sincTaps; t++)
+                    values[p * sincTaps + t] = (float) (coeffs[p][t] / sum);
+            }
+        }
+
+        double coeffs[sincPhases][sincTaps];
+        float values[sincPhases * sincTaps];
+
+    } table;
+
+    return table.values;
+}
+
+const float* AmiVoiceBank::getBlepTable()
+{
+    static const struct Table_t
+    {
+        Table_t()
+        {
+            // minBLEP (Brandt): a Blackman windowed sinc at blepOversample x the output rate,
+            // made minimum phase through its real cepstrum so the whole step lies after the
+            // transition, then integrated
+
+            constexpr double pi = juce::MathConstants<double>::pi;
+            constexpr int zeroCrossings = blepLength / 2, fftSize = 8192;
+            constexpr int impulseLength = 2 * zeroCrossings * blepOversample + 1;
+
+            std::vector<std::complex<double>> x((size_t) fftSize);
+
+            for (int i = 0; i < impulseLength; i++)
+            {
+                const double t = (double) (i - zeroCrossings * blepOversample) / blepOversample;
+                const double sinc = t == 0.0 ? 1.0 : std::sin(pi * t) / (pi * t);
+                const double phase = 2.0 * pi * i / (impulseLength - 1);
+
+                x[(size_t) i] = sinc * (0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+            }
+
+            fft(x.data(), fftSize, false);
+
+            for (auto& bin : x)
+                bin = std::log(juce::jmax(std::abs(bin), 1e-100));
+
+            fft(x.data(), fftSize, true);
+
+            // fold the cepstrum onto positive quefrencies
+            for (int i = 1; i < fftSize / 2; i++)
+            {
+                x[(size_t) i] *= 2.0;
+                x[(size_t) (fftSize - i)] = 0.0;
+            }
+
+            fft(x.data(), fftSize, false);
+
+            for (auto& bin : x)
+                bin = std::exp(bin);
+
+            fft(x.data(), fftSize, true);
+
+            double total = 0.0;
+
+            for (int i = 0; i < impulseLength; i++)
+                total += x[(size_t) i].real();
+
+            constexpr int numPoints = blepLength * blepOversample;
+            double step = 0.0;
+
+            for (int i = 0; i < numPoints; i++)
+            {
+                values[i] = (float) (1.0 - step / total);
+                step += x[(size_t) i].real();
+            }
+
+            values[numPoints] = 0.f;
+        }
+
+        float values[blepLength * blepOversample + 1];
+
+    } table;
+
+    return table.values;
+}
+
+void AmiVoiceBank::blepAdd(float* ring, const int index, const float offset, const float amplitude)
+{
+    const float* table = getBlepTable();
+
+    const float point = offset * blepOversample;
+    const int first = juce::jlimit(0, blepOversample - 1, (int) point);
+    const float frac = point - (float) first;
+
+    for (int n = 0; n < blepLength; n++)
+    {
+        const float* c = table + first + n * blepOversample;
+
+        ring[(index + n) & (blepLength - 1)] += amplitude * (c[0] + (c[1] - c[0]) * frac);
+    }
+}
+
+template <int interpolation>
+float AmiVoiceBank::readSample(const int8_t* in, const int idx, const float frac)
+{
+    if constexpr (interpolation == interpNearest)
+    {
+        juce::ignoreUnused(frac);
+        return fromAmi8Bit(in[idx]);
+    }
+    else
+    {
+        // taps either side of the sample land in its guard, see AmiSampleBlock
+        const float* ami = getAmi8BitTable();
+        const auto at = [in, ami](const int i) { return ami[in[i]]; };
+
+        if constexpr (interpolation == interpLinear)
+        {
+            const float s0 = at(idx), s1 = at(idx + 1);
+
+            return s0 + (s1 - s0) * frac;
+        }
+        else if constexpr (interpolation == interpCubic)
+        {
+            // 4-point Catmull-Rom
+            const float sm1 = at(idx - 1), s0 = at(idx), s1 = at(idx + 1), s2 = at(idx + 2);
+
+            return s0 + 0.5f * frac * (s1 - sm1 + frac * (2.f * sm1 - 5.f * s0 + 4.f * s1 - s2
+                                                          + frac * (3.f * (s0 - s1) + s2 - sm1)));
+        }
+        else
+        {
+            const float* coeffs = getSincTable() + juce::jmin(sincPhases - 1, (int) (frac * sincPhases)) * sincTaps;
+            const int first = idx - (sincTaps / 2 - 1);
+
+            float taps[sincTaps], sum = 0.f;
+
+            // gather first, then a fixed-length dot product the compiler can vectorize
+            for (int t = 0; t < sincTaps; t++)
+                taps[t] = at(first + t);
+
+            for (int t = 0; t < sincTaps; t++)
+                sum += taps[t] * coeffs[t];
+
+            return sum;
+        }
+    }
+}
+
+void AmiVoiceBank::renderGroup(const int* lanes, const int numLanes, const SlotState_t& slot,
+                               const float envelope[][chunkSize], const int* envLength,
+                               const float* vibrato, float* outL, float* outR, const int numSamples, bool* finished)
+{
+    static const Kernel* kernels = getKernels(std::make_integer_sequence<int, numInterpolationModes * numLoopModes * numKernelFlags>());
+
+    // one specialized loop per mode, picked once per chunk
+
+    const int interpolation = slot.interpolation >= 0 && slot.interpolation < numInterpolationModes ? slot.interpolation : interpNearest;
+    const int loopMode = !slot.loopEnable ? loopOff : slot.pingPong ? loopPingPong : loopForward;
+
+    const int flags = (slot.streamed ? kernelStreamed : 0)
+                    | (slot.inR != nullptr ? kernelStereoIn : 0)
+                    | (outR != nullptr ? kernelStereoOut : 0)
+                    | (slot.panLR != 0.f || slot.panRL != 0.f ? kernelCrossPan : 0);
+
+    const Kernel kernel = kernels[(interpolation * numLoopModes + loopMode) * numKernelFlags + flags];
+
+    (this->*kernel)(lanes, numLanes, slot, envelope, envLength, vibrato, outL, outR, numSamples, finished);
+}
+
+template <int... modes>
+const AmiVoiceBank::Kernel* AmiVoiceBank::getKernels(std::integer_sequence<int, modes...>)
+{
+    static const Kernel kernels[] = { &AmiVoiceBank::renderLanes<modes / (numLoopModes * numKernelFlags),
+                                                                 (modes / numKernelFlags) % numLoopModes,
+                                                                 modes % numKernelFlags>... };
+    return kernels;
+}
+
+template <int interpolation, int loopMode, int flags>
+void AmiVoiceBank::renderLanes(const int* lanes, const int numLanes, const SlotState_t& slot,
+                               const float envelope[][chunkSize], const int* envLength,
+                               const float* vibrato, float* outL, float* outR, const int numSamples, bool* finished)
+{
+    constexpr bool streamed  = (flags & kernelStreamed) != 0;
+    constexpr bool stereoIn  = (flags & kernelStereoIn) != 0;
+    constexpr bool stereoOut = (flags & kernelStereoOut) != 0;
+    constexpr bool crossPan  = (flags & kernelCrossPan) != 0;
+    constexpr bool looping   = loopMode == loopForward;
+    constexpr bool pingPong  = loopMode == loopPingPong;
+
+    static const float silence[chunkSize] = {};
+
+    jassert(numLanes > 0 && numLanes <= laneWidth);
+    jassert(numSamples <= chunkSize);
+
+    int64_t pos[laneWidth], rate[laneWidth], target[laneWidth], gliss[laneWidth], step[laneWidth];
+    double  bendRatio[laneWidth];
+    float  gl[laneWidth], gr[laneWidth];
+    bool   forward[laneWidth], up[laneWidth], alive[laneWidth], steady[laneWidth];
+    int    envLen[laneWidth];
+
+    const float* env[laneWidth];
+
+    // load the group into local lanes, padding unused lanes as silent
+
+    for (int k = 0; k < laneWidth; k++)
+    {
+        const bool used = k < numLanes;
+        const int lane = lanes[used ? k : 0];
+
+        pos[k]       = used ? position[lane] : 0;
+        rate[k]      = pitch[lane];
+        target[k]    = pitchTarget[lane];
+        gliss[k]     = glissStep[lane];
+        bendRatio[k] = bend[lane];
+        forward[k]   = playForward[lane];
+        up[k]        = slideUp[lane];
+
+        gl[k] = used ? gainL[lane] * slot.volume : 0.f;
+        gr[k] = used ? gainR[lane] * slot.volume : 0.f;
+
+        env[k]    = used ? envelope[k] : silence;
+        envLen[k] = used ? envLength[k] : 0;
+        alive[k]  = envLen[k] > 0;
+    }
+
+    // Paula residual rings; unused lanes get scratch ones so they leave lanes[0] alone
+
+    float scratchRing[laneWidth][2][blepLength];
+    float* ringL[laneWidth];
+    float* ringR[laneWidth];
+    float  lastL[laneWidth], lastR[laneWidth];
+    int    ringIdx[laneWidth];
+    bool   wrapped[laneWidth] = {};
+
+    if constexpr (interpolation == interpPaula)
+    {
+        for (int k = 0; k < laneWidth; k++)
+        {
+            const bool used = k < numLanes;
+            const int lane = lanes[used ? k : 0];
+
+            if (!used) std::fill(scratchRing[k][0], scratchRing[k][0] + 2 * blepLength, 0.f);
+
+            ringL[k]   = used ? blepResidual[lane][0] : scratchRing[k][0];
+            ringR[k]   = used ? blepResidual[lane][1] : scratchRing[k][1];
+            lastL[k]   = blepLast[lane][0];
+            lastR[k]   = blepLast[lane][1];
+            ringIdx[k] = blepIndex[lane];
+            wrapped[k] = blepWrapped[lane];
+        }
+    }
+
+    const int64_t loopStart = (int64_t) slot.loopStart << phaseBits, loopEnd = (int64_t) slot.loopEnd << phaseBits,
+                  loopLength = loopEnd - loopStart, end = (int64_t) slot.length << phaseBits;
+
+    juce::ignoreUnused(loopStart, loopEnd, loopLength);
+
+    // nothing is clamped per sample, so a lane left past its loop or the end of
+    // the sample by new loop points wraps or stops before it reads anything (a
+    // ping-pong one turns round by itself)
+
+    for (int k = 0; k < laneWidth; k++)
+    {
+        if (looping && pos[k] >= loopEnd)
+        {
+            pos[k] = loopLength > 0 ? loopStart + (pos[k] - loopEnd) % loopLength : loopStart;
+            wrapped[k] = true;
+        }
+
+        alive[k] = alive[k] && pos[k] < end;
+    }
+
+    // each lane reads the pyramid level whose step is nearest 1 for this chunk
+
+    const int8_t* srcL[laneWidth];
+    const int8_t* srcR[laneWidth];
+    int srcShift[laneWidth], srcLast[laneWidth];
+
+    for (int k = 0; k < laneWidth; k++)
+    {
+        const double speed = std::abs(fromPhase(rate[k] > 0 ? rate[k] : target[k]) * bendRatio[k]);
+        int level = 0;
+
+        while (level + 1 < slot.numMipLevels && speed >= juce::MathConstants<double>::sqrt2 * (double) (1 << level))
+            level++;
+
+        srcL[k]     = level > 0 ? slot.mipL[level] : slot.inL;
+        srcR[k]     = stereoIn ? (level > 0 ? slot.mipR[level] : slot.inR) : nullptr;
+        srcShift[k] = level;
+        srcLast[k]  = (level > 0 ? slot.mipLength[level] : slot.length) - 1;
+    }
+
+    // without vibrato in this chunk or a glide under way, a lane steps by the
+    // same integer every sample, so it is worked out here once
+
+    bool flat = true;
+
+    for (int i = 1; i < numSamples; i++)
+        flat = flat && vibrato[i] == vibrato[0];
+
+    for (int k = 0; k < laneWidth; k++)
+    {
+        if (!slot.glide) rate[k] = target[k];
+
+        steady[k] = flat && rate[k] == target[k];
+        step[k]   = (int64_t) ((double) rate[k] * ((double) vibrato[0] * bendRatio[k]));
+    }
+
+    // streamed lanes read the head, then the resident loop, then their ring
+
+    const int8_t* stream[laneWidth][2];
+    int streamFrom[laneWidth], streamTo[laneWidth], missed[laneWidth];
+
+    if constexpr (streamed)
+    {
+        for (int k = 0; k < laneWidth; k++)
+        {
+            const bool used = k < numLanes;
+            const int lane = lanes[used ? k : 0];
+
+            stream[k][0]  = streamRing[lane][0];
+            stream[k][1]  = streamRing[lane][1];
+            streamFrom[k] = used ? streamStart[lane] : 0;
+            streamTo[k]   = used ? streamEnd[lane] : 0;
+            missed[k]     = 0;
+        }
+    }
+
+    const auto fetch = [&](const int k, const int ch, const int i) -> int8_t
+    {
+        // the resident loop first: a reversed ping-pong half may overlap the head
+        if (i >= slot.residentStart && i < slot.residentEnd) return (ch == 0 ? slot.loopL : slot.loopR)[i - slot.residentStart];
+        if (i < slot.headLength)                             return (ch == 0 ? slot.inL : slot.inR)[i];
+        if (i >= streamFrom[k] && i < streamTo[k])           return stream[k][ch][i & (streamRingSize - 1)];
+
+        // the disk hasn't caught up: play silence rather than wait
+        missed[k]++;
+        return 0;
+    };
+
+    const auto readStreamed = [&](const int k, const int ch, const int idx, const float frac) -> float
+    {
+        constexpr int centre = sincTaps / 2 - 1;
+        int8_t taps[sincTaps];
+
+        if constexpr (interpolation == interpNearest)
+            taps[centre] = fetch(k, ch, idx);
+        else
+            for (int t = 0; t < sincTaps; t++)
+                taps[t] = fetch(k, ch, juce::jlimit(0, srcLast[k], idx - centre + t));
+
+        return readSample<interpolation>(taps, centre, frac);
+    };
+
+    // the sample m before idx along a lane's path, back into the end of its loop
+    // if the lane wrapped to get here
+    const auto pathIndex = [&](const int k, const int idx, const int m) -> int
+    {
+        if (pingPong && !forward[k]) return juce::jmin(srcLast[k], idx + m);
+
+        const int i = idx - m;
+
+        if (looping && wrapped[k] && i < slot.loopStart && slot.loopEnd > slot.loopStart)
+            return slot.loopEnd - 1 - (slot.loopStart - 1 - i) % (slot.loopEnd - slot.loopStart);
+
+        return juce::jmax(0, i);
+    };
+
+    juce::ignoreUnused(fetch, readStreamed, pathIndex);
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        float sampL[laneWidth], sampR[laneWidth];
+
+        // glide toward the target pitch (mono mode only) and work out this sample's step
+
+        for (int k = 0; k < laneWidth; k++)
+        {
+            if (steady[k]) continue;
+
+            const int64_t nextPitch = rate[k] + gliss[k];
+            const bool overshoot = up[k] ? nextPitch > target[k] : nextPitch < target[k];
+
+            rate[k] = (!slot.glide || rate[k] <= 0 || overshoot) ? target[k] : nextPitch;
+            step[k] = (int64_t) ((double) rate[k] * ((double) vibrato[i] * bendRatio[k]));
+        }
+
+        // gather: finished lanes are pointed at the first sample so they never read out of bounds
+
+        for (int k = 0; k < laneWidth; k++)
+        {
+            const int64_t srcPos = alive[k] ? pos[k] >> srcShift[k] : 0;
+
+            const int idx = (int) (srcPos >> phaseBits);
+            const float frac = (float) (srcPos & (phaseOne - 1)) * (1.f / (float) phaseOne);
+
+            if constexpr (interpolation == interpPaula)
+            {
+                // hold the sample, replacing each step with a band-limited one placed
+                // where the read position crossed into the new sample. Above unity
+                // pitch every sample crossed since the last output gets its own step,
+                // oldest first; any past maxBlepSteps are merged into the oldest
+                const float* ami = getAmi8BitTable();
+                const float speed = (float) std::abs(fromPhase(step[k]));
+                const float since = pingPong && !forward[k] ? 1.f - frac : frac;
+                const int crossed = juce::jlimit(0, maxBlepSteps - 1, (int) std::ceil(speed - since) - 1);
+
+                for (int m = crossed; m >= 0; m--)
+                {
+                    const int j = pathIndex(k, idx, m);
+                    const float elapsed = speed > 0.f ? juce::jmin(0.999f, (since + (float) m) / speed) : 0.f;
+
+                    const float l = ami[streamed ? fetch(k, 0, j) : srcL[k][j]];
+
+                    if (l != lastL[k]) { blepAdd(ringL[k], ringIdx[k], elapsed, lastL[k] - l); lastL[k] = l; }
+
+                    if constexpr (stereoIn)
+                    {
+                        const float r = ami[streamed ? fetch(k, 1, j) : srcR[k][j]];
+
+                        if (r != lastR[k]) { blepAdd(ringR[k], ringIdx[k], elapsed, lastR[k] - r); lastR[k] = r; }
+                    }
+                }
+
+                sampL[k] = lastL[k] + ringL[k][ringIdx[k]];
+                ringL[k][ringIdx[k]] = 0.f;
+
+                if constexpr (stereoIn)
+                {
+                    sampR[k] = lastR[k] + ringR[k][ringIdx[k]];
+                    ringR[k][ringIdx[k]] = 0.f;
+                }
+                else
+                {
+                    sampR[k] = sampL[k];
+                }
+
+                ringIdx[k] = (ringIdx[k] + 1) & (blepLength - 1);
+            }
+            else if constexpr (streamed)
+            {
+                sampL[k] = readStreamed(k, 0, idx, frac);
+                sampR[k] = stereoIn ? readStreamed(k, 1, idx, frac) : sampL[k];
+            }
+            else
+            {
+                sampL[k] = readSample<interpolation>(srcL[k], idx, frac);
+                sampR[k] = stereoIn ? readSample<interpolation>(srcR[k], idx, frac) : sampL[k];
+            }
+        }
+
+        // scale, apply gain and envelope and pan each lane, adding it to the
+        // output in voice order as the per-voice render did, so the sums round
+        // the same way
+
+        for (int k = 0; k < laneWidth; k++)
+        {
+            if (!alive[k]) continue;
+
+            const float e = env[k][i];
+
+            const float l = sampL[k] * (gl[k] * e);
+            const float r = sampR[k] * (gr[k] * e);
+
+            const float panned[2] = { crossPan ? (l * slot.panLL) + (r * slot.panLR) : l * slot.panLL,
+                                      crossPan ? (r * slot.panRR) + (l * slot.panRL) : r * slot.panRR };
+
+            if constexpr (stereoOut)
+            {
+                outL[i] += panned[0];
+                outR[i] += panned[1];
+            }
+            else
+            {
+                outL[i] += (panned[0] + panned[1]) * 0.5f;
+            }
+        }
+
+        // advance, wrapping forward loops (unrolled ping-pong ones included, see
+        // mirrorEnd) or turning round at the ends of a ping-pong one
+
+        for (int k = 0; k < laneWidth; k++)
+        {
+            const int64_t nextPos = pos[k] + step[k];
+
+            if constexpr (looping)
+            {
+                // keep the phase that ran past the end, as Paula does when it reloads the loop
+                pos[k] = nextPos < loopEnd ? nextPos
+                       : loopLength > 0 ? loopStart + (nextPos - loopEnd) % loopLength : loopStart;
+
+                wrapped[k] = nextPos >= loopEnd;
+            }
+            else if constexpr (pingPong)
+            {
+                const int64_t prevPos = pos[k] - step[k];
+
+                forward[k] = forward[k] ? (nextPos < loopEnd) : (prevPos < loopStart);
+                pos[k] = forward[k] ? nextPos : prevPos;
+            }
+            else
+            {
+                pos[k] = nextPos;
+            }
+
+            alive[k] = alive[k] && (i + 1 < envLen[k]) && pos[k] < end;
+        }
+    }
+
+    // store the group back into the bank
+
+    for (int k = 0; k < numLanes; k++)
+    {
+        const int lane = lanes[k];
+
+        position[lane]    = pos[k];
+        pitch[lane]       = rate[k];
+        playForward[lane] = forward[k];
+
+        if constexpr (streamed)
+            streamMisses[lane] += missed[k];
+
+        if constexpr (interpolation == interpPaula)
+        {
+            blepLast[lane][0] = lastL[k];
+            blepLast[lane][1] = lastR[k];
+            blepIndex[lane]   = ringIdx[k];
+            blepWrapped[lane] = wrapped[k];
+        }
+
+        finished[k] = !alive[k];
+    }
+}
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+    AmiVoiceBank.h
+    Created: 17 Oct 2026 10:12:40am
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/*
+  ==============================================================================
+
+
+  //// Structure-of-arrays voice state and multi-voice render kernel ////
+
+  Each voice in the pool owns one lane of the bank. Voices playing the same sound are
+  rendered together, laneWidth at a time, so the per-lane loops below can be
+  kept in SIMD registers instead of walking one voice at a time.
+
+  ==============================================================================
+*/
+
+class AmiVoiceBank
+{
+public:
+
+    AmiVoiceBank();
+    ~AmiVoiceBank();
+
+    static constexpr int maxVoices = 96;   // 12 samplers x 8 voices, shared through AmiVoicePool
+    static constexpr int laneWidth = 4;
+    static constexpr int chunkSize = 64;
+
+    /** How a lane reads between sample points. Nearest is the original point
+        sampling; the others read the 8-bit data through a float lookup. Paula
+        holds each sample like nearest but band-limits every step between them.
+    */
+    enum Interpolation
+    {
+        interpNearest, interpLinear, interpCubic, interpSinc, interpPaula,
+
+        numInterpolationModes
+    };
+
+    static constexpr int sincTaps = 8;       // per output sample, centred on the read position
+    static constexpr int sincPhases = 256;   // fractional positions in the coefficient table
+
+    static constexpr int maxMipLevels = 7;   // the sample plus up to six octaves down
+
+    static constexpr int blepLength = 16;       // output samples a step's residual lasts, a power of 2
+    static constexpr int blepOversample = 32;   // BLEP table points per output sample
+    static constexpr int maxBlepSteps = 16;     // most sample steps given their own BLEP per output sample
+
+    static constexpr int streamRingSize = 1 << 16;   // read-ahead samples per lane and side, a power of 2
+
+    /** Positions and pitches are 32.32 fixed point: the top half counts whole
+        samples, the bottom half the phase between them, like Paula's DMA pointer
+        stepping on its period counter.
+    */
+    static constexpr int phaseBits = 32;
+    static constexpr int64_t phaseOne = (int64_t) 1 << phaseBits;
+
+    static int64_t toPhase(const double value)   { return (int64_t) (value * (double) phaseOne); }
+    static double fromPhase(const int64_t phase) { return (double) phase * (1.0 / (double) phaseOne); }
+
+    static constexpr float maxFineTune = 50.f;   // cents either way
+    static constexpr int fineTuneSteps = 127;    // steps either way, as the "FINE TUNE" parameter moves
+
+    /** The per-sample step for a note the given number of semitones from the root,
+        read from a semitone x fine tune table and scaled by source rate / device rate.
+    */
+    static int64_t getNoteIncrement(const int semitones, const float fineTune, const double rateRatio);
+
+    /** Per-block settings shared by every lane of a group. Channel volume is
+        applied with each lane's gain, ahead of the envelope and the pan matrix,
+        in the order the per-voice render multiplied them.
+    */
+    typedef struct SlotState_t
+    {
+    public:
+
+        const int8_t* inL;
+        const int8_t* inR;
+
+        int length, loopStart, loopEnd;
+        bool loopEnable, pingPong, glide;
+        int interpolation;
+
+        // octave pyramid: level n holds the sample band-limited and decimated by 2^n,
+        // level 0 being inL/inR. Positions and loop points stay in level 0 samples.
+        const int8_t* mipL[maxMipLevels];
+        const int8_t* mipR[maxMipLevels];
+        int mipLength[maxMipLevels], numMipLevels;
+
+        // direct-from-disk samples: inL/inR only hold the first headLength samples, the
+        // loop region [residentStart, residentEnd) is in loopL/loopR and every other
+        // position comes from the lane's stream ring
+        bool streamed;
+        int headLength, residentStart, residentEnd;
+        const int8_t* loopL;
+        const int8_t* loopR;
+
+        // ping-pong loops are played from a copy of the loop followed by its reverse as a
+        // forward loop; positions from mirrorEnd on are in the reversed half (0 when there
+        // is none). Without a copy matching the loop, pingPong has the kernel turn the
+        // lanes round at the loop points instead
+        int mirrorEnd;
+
+        float volume;
+        float panLL, panLR, panRL, panRR;
+
+    } SlotState_t;
+
+    void resetLane(const int lane);
+
+    /** Drops a lane's pending Paula residual, for a note that restarts its sample. */
+    void clearBlep(const int lane);
+
+    /** Renders up to laneWidth lanes into outL/outR (outR may be nullptr for mono),
+        with vibrato holding the shared per-sample vibrato ratio for the same span.
+
+        envelope[k] holds numSamples of envelope for lanes[k] and envLength[k] is
+        the number of samples its ADSR stays active for (anything above numSamples
+        means it is still running at the end of the chunk). On return,
+        finished[k] is set for every lane that ran off the end of its sample or
+        envelope and should be stopped by its voice.
+    */
+    void renderGroup(const int* lanes, const int numLanes, const SlotState_t& slot,
+                     const float envelope[][chunkSize], const int* envLength,
+                     const float* vibrato, float* outL, float* outR, const int numSamples, bool* finished);
+
+    /** Scales a pre-quantized 8-bit sample back to float, inverted as Paula's output is.
+        This divides rather than multiplying by the reciprocal, as the float path
+        before it did, so every byte value scales to exactly the same float.
+    */
+    static float fromAmi8Bit(const int8_t samp) { return -((float) samp / (samp < 0 ? 128.f : 127.f)); }
+
+    // 32.32 fixed point, see phaseBits
+    alignas(32) int64_t position[maxVoices], pitch[maxVoices], pitchTarget[maxVoices], glissStep[maxVoices];
+
+    alignas(32) double bend[maxVoices];
+
+    alignas(32) float gainL[maxVoices], gainR[maxVoices];
+
+    bool playForward[maxVoices], slideUp[maxVoices];
+
+    // streamed lanes: the ring and the positions it holds for the coming chunk, and
+    // how many positions the kernel found missing
+    const int8_t* streamRing[maxVoices][2];
+    int streamStart[maxVoices], streamEnd[maxVoices], streamMisses[maxVoices];
+
+private:
+
+    /** The rest of what the kernel is compiled for. renderGroup() picks the
+        instantiation once per chunk, so none of these is tested per sample.
+    */
+    enum LoopMode { loopOff, loopForward, loopPingPong, numLoopModes };
+
+    enum KernelFlags
+    {
+        kernelStreamed  = 1 << 0,   // reads through the lanes' stream rings
+        kernelStereoIn  = 1 << 1,   // the sample has a right channel
+        kernelStereoOut = 1 << 2,   // there is a right output to write
+        kernelCrossPan  = 1 << 3,   // Paula stereo width: each side also feeds the other
+
+        numKernelFlags  = 1 << 4
+    };
+
+    typedef void (AmiVoiceBank::*Kernel) (const int*, const int, const SlotState_t&, const float[][chunkSize], const int*,
+                                          const float*, float*, float*, const int, bool*);
+
+    /** Every renderLanes() instantiation, indexed by
+        (interpolation * numLoopModes + loop mode) * numKernelFlags + flags.
+    */
+    template <int... modes>
+    static const Kernel* getKernels(std::integer_sequence<int, modes...>);
+
+    template <int interpolation, int loopMode, int flags>
+    void renderLanes(const int* lanes, const int numLanes, const SlotState_t& slot,
+                     const float envelope[][chunkSize], const int* envLength,
+                     const float* vibrato, float* outL, float* outR, const int numSamples, bool* finished);
+
+    /** Reads in at idx + frac. The taps on either side aren't clamped, so in must
+        be readable for sincTaps / 2 samples past both ends.
+    */
+    template <int interpolation>
+    static float readSample(const int8_t* in, const int idx, const float frac);
+
+    /** Adds a step of amplitude (old value - new value) that happened offset
+        output samples ago to the residual ring starting at index.
+    */
+    static void blepAdd(float* ring, const int index, const float offset, const float amplitude);
+
+    /** fromAmi8Bit() for every byte value, so the wider kernels don't branch per tap. */
+    static const float* getAmi8BitTable();
+
+    /** Blackman windowed sinc coefficients, sincTaps per phase, each phase normalised to unity gain. */
+    static const float* getSincTable();
+
+    /** Minimum-phase band-limited step minus the ideal step, blepOversample
+        points per output sample for blepLength samples, plus one guard point.
+    */
+    static const float* getBlepTable();
+
+    // Paula mode: per lane and side, the residual still to be added to the coming
+    // output samples (a ring read from blepIndex), the last sample value held and
+    // whether the lane's last step wrapped its loop
+    alignas(32) float blepResidual[maxVoices][2][blepLength];
+    float blepLast[maxVoices][2];
+    int blepIndex[maxVoices];
+    bool blepWrapped[maxVoices];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiVoiceBank)
+};
@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    AmiVoicePool.cpp
+    Created: 17 Oct 2026 2:21:37pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AmiVoicePool.h"
+#include "AmiSamplerSound.h"
+
+AmiVoicePool::AmiVoicePool()
+{
+    for (int v = 0; v < maxVoices; v++)
+    {
+        state[v] = stateFree;
+        slotOf[v] = -1;
+        prev[v] = next[v] = slotPrev[v] = slotNext[v] = -1;
+    }
+}
+
+AmiVoicePool::~AmiVoicePool() {}
+
+void AmiVoicePool::allocateVoices(AmiAudioProcessor& p)
+{
+    if (voices.size() > 0) return;
+
+    voices.ensureStorageAllocated(maxVoices);
+
+    for (int v = 0; v < maxVoices; v++)
+    {
+        voices.add(new AmiSamplerVoice(p, *this, v));
+        pushBack(freeList, v, prev, next);
+    }
+}
+
+AmiSamplerVoice* AmiVoicePool::claimVoice(const int slot, const int slotLimit)
+{
+    jassert(slot >= 0 && slot < maxSlots);
+
+    if (voices.size() == 0) return nullptr;
+
+    int v = -1;
+
+    if (slotLists[slot].size >= juce::jmax(1, slotLimit))
+        v = slotLists[slot].head;
+    else if (getNumActive() < polyphonyLimit && freeList.size > 0)
+        v = freeList.head;
+    else
+        v = releasedList.size > 0 ? releasedList.head : heldList.head;
+
+    if (v < 0) v = freeList.head;
+    if (v < 0) return nullptr;
+
+    unlink(listFor(state[v]), v, prev, next);
+
+    if (state[v] != stateFree)
+        unlink(slotLists[slotOf[v]], v, slotPrev, slotNext);
+
+    // a voice coming from another slot, or from the free list, must not glide on from its last note
+    if (slotOf[v] != slot || state[v] == stateFree)
+        voices.getUnchecked(v)->resetNoteState();
+
+    state[v] = stateClaimed;
+    slotOf[v] = slot;
+
+    return voices.getUnchecked(v);
+}
+
+void AmiVoicePool::voiceStarted(const AmiSamplerVoice& voice, const int slot)
+{
+    const int v = voice.getLane();
+
+    if (state[v] != stateClaimed) return;
+
+    state[v] = stateHeld;
+    slotOf[v] = slot;
+
+    pushBack(heldList, v, prev, next);
+    pushBack(slotLists[slot], v, slotPrev, slotNext);
+}
+
+void AmiVoicePool::voiceReleased(const AmiSamplerVoice& voice)
+{
+    const int v = voice.getLane();
+
+    if (state[v] != stateHeld) return;
+
+    unlink(heldList, v, prev, next);
+    pushBack(releasedList, v, prev, next);
+
+    state[v] = stateReleased;
+}
+
+void AmiVoicePool::voiceStopped(const AmiSamplerVoice& voice)
+{
+    const int v = voice.getLane();
+
+    // claimed voices are being restarted by their new owner, so leave them be
+    if (state[v] != stateHeld && state[v] != stateReleased) return;
+
+    unlink(listFor(state[v]), v, prev, next);
+    unlink(slotLists[slotOf[v]], v, slotPrev, slotNext);
+    pushBack(freeList, v, prev, next);
+
+    state[v] = stateFree;
+}
+
+int AmiVoicePool::getSlotVoices(const int slot, AmiSamplerVoice** dest) const
+{
+    int numVoices = 0;
+
+    for (int v = slotLists[slot].head; v >= 0; v = slotNext[v])
+        dest[numVoices++] = voices.getUnchecked(v);
+
+    return numVoices;
+}
+
+AmiVoicePool::VoiceList_t& AmiVoicePool::listFor(const int voiceState)
+{
+    switch (voiceState)
+    {
+        case stateHeld:     return heldList;
+        case stateReleased: return releasedList;
+        default:            return freeList;
+    }
+}
+
+void AmiVoicePool::pushBack(VoiceList_t& list, const int v, int* prev, int* next)
+{
+    prev[v] = list.tail;
+    next[v] = -1;
+
+    if (list.tail >= 0) next[list.tail] = v;
+    else list.head = v;
+
+    list.tail = v;
+    list.size++;
+}
+
+void AmiVoicePool::unlink(VoiceList_t& list, const int v, int* prev, int* next)
+{
+    if (prev[v] >= 0) next[prev[v]] = next[v];
+    else list.head = next[v];
+
+    if (next[v] >= 0) prev[next[v]] = prev[v];
+    else list.tail = prev[v];
+
+    prev[v] = next[v] = -1;
+    list.size--;
+}
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    AmiVoicePool.h
+    Created: 17 Oct 2026 2:21:37pm
+    Author:  _astriid_
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AmiVoiceBank.h"
+
+class AmiAudioProcessor;
+class AmiSamplerVoice;
+
+/*
+  ==============================================================================
+
+
+  //// Global voice pool shared by all samplers ////
+
+  Every voice the plugin can ever play is created once, the first time
+  prepareToPlay() is called, each one owning a lane of the shared voice bank.
+  Samplers borrow voices from here on note-on and hand them back when they
+  stop, so "MONO POLY" only changes a per-slot limit and never allocates.
+
+  Each voice sits in exactly one of three intrusive lists, all kept in the
+  order voices entered them: free, held (key down) and released (tailing
+  off). Released voices are already fading, so the head of the released list
+  stands in for the quietest voice and the head of the held list for the
+  oldest; stealing either is a constant-time unlink.
+
+  ==============================================================================
+*/
+
+class AmiVoicePool
+{
+public:
+
+    AmiVoicePool();
+    ~AmiVoicePool();
+
+    static constexpr int maxVoices = AmiVoiceBank::maxVoices;
+    static constexpr int maxSlots = 12;
+
+    /** Creates the voices. Only the first call allocates; later calls do nothing. */
+    void allocateVoices(AmiAudioProcessor&);
+
+    /** Limits how many voices may sound at once across every slot. */
+    void setPolyphonyLimit(const int limit) { polyphonyLimit = juce::jlimit(1, maxVoices, limit); }
+    int  getPolyphonyLimit() const { return polyphonyLimit; }
+
+    AmiVoiceBank& getVoiceBank() { return bank; }
+
+    /** Takes a voice for the slot, stealing one if the slot already has slotLimit
+        voices or the pool is at its polyphony limit. The voice is detached from
+        every list until voiceStarted() is called for it. Returns nullptr if the
+        voices haven't been allocated yet.
+    */
+    AmiSamplerVoice* claimVoice(const int slot, const int slotLimit);
+
+    /** Files a claimed voice under the slot as a held (key down) voice. */
+    void voiceStarted(const AmiSamplerVoice&, const int slot);
+
+    /** Moves a held voice to the released list when its note starts tailing off. */
+    void voiceReleased(const AmiSamplerVoice&);
+
+    /** Returns a held or released voice to the free list. */
+    void voiceStopped(const AmiSamplerVoice&);
+
+    /** Copies the slot's sounding voices, oldest first, and returns how many there are. */
+    int getSlotVoices(const int slot, AmiSamplerVoice** dest) const;
+
+    int getNumActive() const { return heldList.size + releasedList.size; }
+    int getNumActive(const int slot) const { return slotLists[slot].size; }
+
+private:
+
+    enum VoiceState { stateFree, stateHeld, stateReleased, stateClaimed };
+
+    typedef struct VoiceList_t
+    {
+    public:
+
+        int head = -1, tail = -1, size = 0;
+
+    } VoiceList_t;
+
+    static void pushBack(VoiceList_t& list, const int v, int* prev, int* next);
+    static void unlink(VoiceList_t& list, const int v, int* prev, int* next);
+
+    VoiceList_t& listFor(const int state);
+
+    juce::OwnedArray<AmiSamplerVoice> voices;
+    AmiVoiceBank bank;
+
+    // free, held and released share one set of links; the per-slot lists have their own
+    int state[maxVoices], slotOf[maxVoices];
+    int prev[maxVoices], next[maxVoices];
+    int slotPrev[maxVoices], slotNext[maxVoices];
+
+    VoiceList_t freeList, heldList, releasedList;
+    VoiceList_t slotLists[maxSlots];
+
+    std::atomic<int> polyphonyLimit { maxVoices };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmiVoicePool)
+};
@@ -85,7 +85,7 @@ AmiWindowEditor::AmiWindowEditor (AmiAudioProcessor& p)
     setWantsKeyboardFocus(true);
     setRepaintsOnMouseActivity(false);
 
-    audioProcessor.getMidiCollector().reset(audioProcessor.getDevSampleRate());
+    audioProcessor.getSampleLoader().addListener(this);
 
     juce::zeromem(keysPressed, 50);
 
@@ -95,6 +95,8 @@ AmiWindowEditor::AmiWindowEditor (AmiAudioProcessor& p)
 
 AmiWindowEditor::~AmiWindowEditor()
 {
+    audioProcessor.getSampleLoader().removeListener(this);
+
     for (int i = 0; i < numWaveforms; i++)
         audioProcessor.getAPVTS().removeParameterListener("LOOP ENABLE" + juce::String(i), this);
 }
@@ -103,7 +105,7 @@ AmiWindowEditor::~AmiWindowEditor()
 void AmiWindowEditor::paint (juce::Graphics& g)
 {
     const int midiChannel = audioProcessor.getMidiChannel((currentSample = audioProcessor.getCurrentSample()));
-    const int samp_len = audioProcessor.getWaveForm(currentSample).getNumSamples();
+    const int samp_len = audioProcessor.getSampleLength(currentSample);
 
     g.fillAll(JPAL(AMI_BLU));
     g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
@@ -197,6 +199,23 @@ void AmiWindowEditor::paintOverChildren(juce::Graphics& g)
     g.setColour(JPAL(scrollcolor));
     g.fillRect(scroll_bar);
 
+    const float loadProgress = audioProcessor.getSampleLoader().getProgress(currentSample);
+
+    if (loadProgress >= 0.f)
+    {
+        const juce::Rectangle progressBar = scrollBack.withWidth((int) ((float) scrollBack.getWidth() * loadProgress));
+
+        g.setColour(JPAL(AMI_BLU));
+        g.fillRect(scrollBack);
+
+        g.setColour(JPAL(AMI_YLW));
+        g.fillRect(progressBar);
+
+        g.setColour(JPAL(AMI_WHT));
+        g.setFont(pixelFont.withHeight(20.f));
+        g.drawText("LOADING " + juce::String((int) (loadProgress * 100.f)) + "%", scrollBack, juce::Justification::centred, false);
+    }
+
     g.setColour(JPAL(0xA0121212));
     
     if(lowNote > 36)
@@ -494,21 +513,32 @@ void AmiWindowEditor::handleExtraNoteOff(const int note)
 
 void AmiWindowEditor::handleLoad(const juce::File& file)
 {
-    if (!audioProcessor.loadFile(file.getFullPathName()))
+    handleLoad(file, currentSample);
+}
+
+void AmiWindowEditor::handleLoad(const juce::File& file, const int slot)
+{
+    audioProcessor.getSampleLoader().loadAsync(slot, file);
+
+    repaint(scrollBack);
+}
+
+void AmiWindowEditor::sampleLoadFinished(const AmiSampleLoader::LoadResult_t& result)
+{
+    if (!result.succeeded)
     {
         alertWinTitle = "Unable to Load File";
-        alertWinMesage = "Error while loading\n" + file.getFileName();
+        alertWinMesage = "Error while loading\n" + result.file.getFileName();
 
         showAlertWin = true;
 
         return;
     }
 
-    audioProcessor.setCurrentSample(currentSample);
+    waveform[result.slot]->resetZoom();
 
-    waveform[currentSample]->resetZoom();
+    loadWaves(result.slot);
 
-    loadWaves();
     drawWaveMenu();
 
     repaint(getBounds().withHeight(proportionOfHeight(0.5f)));
@@ -516,21 +546,21 @@ void AmiWindowEditor::handleLoad(const juce::File& file)
 
 void AmiWindowEditor::loadWaves()
 {
-    const int numSamples = audioProcessor.getWaveForm(currentSample).getNumSamples();
-    const float* sampBuf = audioProcessor.getWaveForm(currentSample).getReadPointer(0);
-
-    waveform[currentSample]->setSampLen(numSamples);
+    loadWaves(currentSample);
+}
 
-    for (int i = 0; i < numSamples; i++)
-        waveform[currentSample]->setPixelWave((int16_t) std::floor(sampBuf[i] * INT16_MAX), i);
+void AmiWindowEditor::loadWaves(const int slot)
+{
+    // the view draws straight from the processor's shared sample buffer
+    waveform[slot]->setPixelWave(audioProcessor.getSampleBuffer(slot));
 
-    waveform[currentSample]->setLoopEnable(audioProcessor.getLoopEnable(currentSample));
-    waveform[currentSample]->setLoopStart(audioProcessor.getLoopStart(currentSample));
-    waveform[currentSample]->setLoopEnd(audioProcessor.getLoopEnd(currentSample));
+    waveform[slot]->setLoopEnable(audioProcessor.getLoopEnable(slot));
+    waveform[slot]->setLoopStart(audioProcessor.getLoopStart(slot));
+    waveform[slot]->setLoopEnd(audioProcessor.getLoopEnd(slot));
 
-    waveform[currentSample]->draw_new_wave();
-    waveform[currentSample]->updateWaveform();
-    waveform[currentSample]->copyPixelBuffer();
+    waveform[slot]->draw_new_wave();
+    waveform[slot]->updateWaveform();
+    waveform[slot]->copyPixelBuffer();
 }
 
 void AmiWindowEditor::drawWaveMenu()
@@ -566,6 +596,11 @@ void AmiWindowEditor::drawWaveMenu()
 void AmiWindowEditor::timerCallback()
 {
     const int samplePos = audioProcessor.getSamplePos();
+    const bool loading = audioProcessor.getSampleLoader().isLoading(currentSample);
+
+    if (loading || wasLoading) repaint(scrollBack);
+
+    wasLoading = loading;
 
     if (lastPos != samplePos)
     {
@@ -596,12 +631,11 @@ void AmiWindowEditor::buttonClicked(juce::Button* button)
     {
         juce::AudioProcessorValueTreeState* APVTS = &audioProcessor.getAPVTS();
      
-        audioProcessor.getSampler(currentSample).clearSounds();
-        audioProcessor.getWaveForm(currentSample).setSize(1, 0);
-        audioProcessor.getWaveForm(currentSample).clear();
+        audioProcessor.getSampleLoader().cancel(currentSample);
+        audioProcessor.setSampleSound(currentSample, nullptr);
+        audioProcessor.setWaveForm(currentSample, nullptr);
 
         APVTS->state.setProperty("pathname" + juce::String(currentSample), "", nullptr);
-        APVTS->state.setProperty("waveformdata" + juce::String(currentSample), "", nullptr);
         APVTS->state.setProperty("samplename" + juce::String(currentSample), "", nullptr);
 
         waveform[currentSample]->setSampLen(0);
@@ -685,7 +719,7 @@ void AmiWindowEditor::buttonClicked(juce::Button* button)
         saveButton.setColour(juce::TextButton::buttonColourId, JPAL(AMI_RED));
         saveButton.setColour(juce::TextButton::textColourOffId, JPAL(AMI_WHT));
 
-        if(audioProcessor.getWaveForm(currentSample).getNumSamples() > 0)
+        if(audioProcessor.getSampleLength(currentSample) > 0)
         {
             std::function<void (const juce::FileChooser&)> callback = [this](const juce::FileChooser& asyncChooser) 
             {
@@ -832,7 +866,7 @@ void AmiWindowEditor::initWaveforms(PixelBuffer* w)
     w->setPixelArea(405, 160);
     w->resetZoom();
 
-    if (audioProcessor.getWaveForm(currentSample).getNumSamples() > 0)
+    if (audioProcessor.getSampleLength(currentSample) > 0)
         loadWaves();
 
     addChildComponent(*w);
@@ -20,7 +20,8 @@
 class AmiWindowEditor  :  public juce::Component,
                           public juce::AudioProcessorValueTreeState::Listener,
                           public juce::Timer,
-                          public juce::Button::Listener
+                          public juce::Button::Listener,
+                          public AmiSampleLoader::Listener
 {
 public:
     AmiWindowEditor(AmiAudioProcessor&);
@@ -39,7 +40,11 @@ public:
     void mouseWheelMove(const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel) override;
 
     void handleLoad(const juce::File&);
+    void handleLoad(const juce::File&, const int slot);
     void loadWaves();
+    void loadWaves(const int slot);
+
+    int getCurrentSample() const { return currentSample; }
 
     void drawWaveMenu();
     void setFont(const juce::Font& font) { pixelFont = font; }
@@ -54,6 +59,7 @@ private:
     void timerCallback() override;
     void buttonClicked(juce::Button* button) override;
     void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void sampleLoadFinished(const AmiSampleLoader::LoadResult_t& result) override;
 
     bool cycleWaveforms(const int key);
     bool switchWaveforms(const juce::KeyPress&);
@@ -84,6 +90,7 @@ private:
     const juce::Rectangle<int> scrollBack{ 32, 290, 747, 28 };
     const juce::Rectangle<int> waveBox{ 0, 0, 810, 320 };
 
+    bool wasLoading = false;
     bool onScrollBar = false, showAlertWin = false, showExtendedOptions = false;
 
     std::unique_ptr<PixelBuffer> waveMenu;
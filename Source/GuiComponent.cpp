@@ -58,7 +58,7 @@ GuiComponent::~GuiComponent()
 
 void GuiComponent::paint (juce::Graphics& g)
 {
-    if (audioProcessor.getWaveForm(currentSample).getNumSamples() < 1)
+    if (audioProcessor.getSampleLength(currentSample) < 1)
         audioProcessor.setLoopEnable(currentSample, false);
     else if(!enableLoop.isEnabled()) enableLoop.setEnabled(true);
 
@@ -230,14 +230,14 @@ void GuiComponent::showMoreOptions(const bool& show)
 
 void GuiComponent::changeSampleChannel(const int &channel)
 {
-    const int numVoices = audioProcessor.getSampler((currentSample = channel)).getNumVoices();
+    const int numVoices = audioProcessor.getSampler((currentSample = channel)).getVoiceLimit();
     const int midiChannel = audioProcessor.getMidiChannel(currentSample);
 
     const int loopStart = audioProcessor.getLoopStart(currentSample);
     const int loopEnd = audioProcessor.getLoopEnd(currentSample);
     const int loopRpln = loopEnd - loopStart;
 
-    const bool loopEnabled = audioProcessor.getLoopEnable(currentSample) && audioProcessor.getWaveForm(currentSample).getNumSamples() > 1;
+    const bool loopEnabled = audioProcessor.getLoopEnable(currentSample) && audioProcessor.getSampleLength(currentSample) > 1;
 
     automateLabelText(&startLoopText, loopStart);
     automateLabelText(&endLoopText, loopEnd);
@@ -538,7 +538,7 @@ void GuiComponent::changeLoopText(juce::Label* l, const int type)
 
     case 2:
 
-        if (val <= audioProcessor.getLoopStart(currentSample) || val > audioProcessor.getWaveForm(currentSample).getNumSamples()) 
+        if (val <= audioProcessor.getLoopStart(currentSample) || val > audioProcessor.getSampleLength(currentSample)) 
             success = false;
 
         if(success) audioProcessor.setLoopEnd(currentSample, val);
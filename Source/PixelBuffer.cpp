@@ -496,18 +496,18 @@ int PixelBuffer::vmap(const int x) const { return (PIXEL_HEIGHT / 2) - ((x * PIX
 int PixelBuffer::scr2samp(const int64_t x) const { return (int)(line_start + ((ROUND32 + (x * samp2wave_scale)) >> 32)); }
 int PixelBuffer::samp2scr(const int64_t x) const { return (int)((ROUND32 + ((x - line_start) * wave2samp_scale)) >> 32); }
 
-void PixelBuffer::setPixelWave(const int16_t val, const int i) 
-{ 
-	if (i > samp_len) return;
+void PixelBuffer::setPixelWave(AmiSampleBuffer::Ptr wave)
+{
+	setSampLen(wave != nullptr ? wave->getLength() : 0);
 
-	pixelWave.set(i, val); 
+	pixelWave = wave;
 }
 
 void PixelBuffer::setSampLen(const int len)
 {
 	samp_len = len;
 
-	if (!pixelWave.isEmpty()) pixelWave.clear();
+	pixelWave = nullptr;
 
 	if (samp_len == 0)
 	{
@@ -517,8 +517,6 @@ void PixelBuffer::setSampLen(const int len)
 		return;
 	}
 
-	pixelWave.resize(samp_len);
-
 	samp2wave_scale = ((int64_t)samp_len << 32) / PIXEL_WIDTH;
 	wave2samp_scale = ((int64_t)PIXEL_WIDTH << 32) / samp_len;
 
@@ -530,12 +528,13 @@ void PixelBuffer::setSampLen(const int len)
 
 int PixelBuffer::draw_new_wave()
 {
-	if (!pixelWave.isEmpty())
+	if (pixelWave != nullptr && samp_len > 0)
 	{
 		allocatePoints(samp_len + 1);
 
+		// reads the shared sample buffer directly instead of keeping a 16-bit copy
 		for (int i = 0; i < samp_len; i++)
-			setPointY(i, vmap(pixelWave.operator[](i)));
+			setPointY(i, vmap(waveValue(i)));
 
 		setPointY(samp_len, point_y.operator[](samp_len - 1));
 	}
@@ -728,7 +727,7 @@ void PixelBuffer::drawWavePolygons()
 
         for (int n = currSampPos; n <= nextSampPos; n++)
         {
-            const int currSampVal = pixelWave.operator[](n);
+            const int currSampVal = waveValue(n);
 
             if (currSampVal < samp_min)
             {
@@ -11,6 +11,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "AmiSampleBuffer.h"
 
 //==============================================================================
 /**
@@ -49,7 +50,7 @@ public:
     void updateWaveform();
     void copyPixelBuffer();
 
-    void setPixelWave(const int16_t val, const int i);
+    void setPixelWave(AmiSampleBuffer::Ptr wave);
     void setSampLen(const int len);
     void setScrollFactor(const int mouse_x);
 
@@ -95,6 +96,12 @@ private:
     int samp2scr(const int64_t x) const;
     int vmap(const int x) const;
 
+    /** The waveform at sample n as 16 bits, read through the overview of a streamed sample. */
+    int16_t waveValue(const int n) const
+    {
+        return (int16_t) std::floor(pixelWave->getReadPointer(0)[n / pixelWave->getStride()] * INT16_MAX);
+    }
+
     void handleZoom(const bool zoom_in);
     void handleScroll(const bool scroll_left);
     void updateZoom(void);
@@ -107,7 +114,7 @@ private:
 
     uint32_t* pixel_pointer = nullptr;
     juce::Array<uint32_t> pixel_buffer;
-    juce::Array <int16_t> pixelWave;
+    AmiSampleBuffer::Ptr pixelWave;
     juce::Array<int> point_x, point_y;
 
     int64_t samp2wave_scale = 0, wave2samp_scale = 0;
@@ -101,7 +101,7 @@ void AmiAudioProcessorEditor::mouseWheelMove(const juce::MouseEvent& e, const ju
 
 bool AmiAudioProcessorEditor::isInterestedInFileDrag(const juce::StringArray& files)
 {
-    if (files.size() != 1) return false;
+    if (files.isEmpty()) return false;
 
     for (const juce::String& fileName : files)
     {
@@ -123,9 +123,17 @@ bool AmiAudioProcessorEditor::isInterestedInFileDrag(const juce::StringArray& fi
 
 void AmiAudioProcessorEditor::filesDropped(const juce::StringArray& files, int, int)
 {
-    if(!isInterestedInFileDrag(files)) return;
+    int slot = amiWindow->getCurrentSample();
 
-    amiWindow->handleLoad(juce::File(files.strings.getFirst()));
+    // several files fill consecutive slots from the current one
+    for (const juce::String& fileName : files)
+    {
+        if (slot >= AmiSampleLoader::maxSlots) break;
+
+        if (!isInterestedInFileDrag(juce::StringArray(fileName))) continue;
+
+        amiWindow->handleLoad(juce::File(fileName), slot++);
+    }
 }
 
 void AmiAudioProcessorEditor::mouseMove(const juce::MouseEvent& e)
@@ -37,6 +37,7 @@ AmiAudioProcessor::AmiAudioProcessor()
     for(int n = 0; n < NUM_SAMPLERS; n++)
     {
         sampler[n].setNoteStealingEnabled(true);
+        sampler[n].setVoicePool(&voicePool, n);
 
         numVoices[n] = 8;
 
@@ -50,6 +51,8 @@ AmiAudioProcessor::AmiAudioProcessor()
         channelMute[n] = channelSolo[n] = sampleMidiChannel[n] = 0;
 
         snh[n] = 1;
+        interpolation[n] = AmiVoiceBank::interpNearest;
+        diskStream[n] = 0;
         sourceSampleRate[n] = resampleRate[n] = 16726.;
 
         midiLowNote[n] = 0;
@@ -68,19 +71,24 @@ AmiAudioProcessor::AmiAudioProcessor()
     sampleMidiChannel[0] = 0;
 
     APVTS.state.addListener(this);
-    keyState.addListener(this);
-    midiCollector.reset(devSampleRate);
 
     voiceRange.setRange(0, 128, true);
+
+    buildParamTargets();
+
+    vibratoIntensityParam = APVTS.getParameter("VIBRATO INTENSITY");
+    startTimerHz(30);
 }
 
 AmiAudioProcessor::~AmiAudioProcessor()
 {
+    sampleLoader.cancelAll();
+    stopTimer();
+
     for (int n = 0; n < NUM_SAMPLERS; n++)
-        sampler[n].clearSounds();
+        setSampleSound(n, nullptr);
 
     formatManager.clearFormats();
-    keyState.removeListener(this);
 }
 
 //==============================================================================
@@ -146,16 +154,19 @@ void AmiAudioProcessor::changeProgramName (int /*index*/, const juce::String& /*
 }
 
 //==============================================================================
-void AmiAudioProcessor::prepareToPlay (double deviceSampleRate, int /*samplesPerBlock*/)
+void AmiAudioProcessor::prepareToPlay (double deviceSampleRate, int samplesPerBlock)
 {
     devSampleRate = deviceSampleRate;
 
+    vibratoBuffer.setSize(1, samplesPerBlock);
+
+    voicePool.allocateVoices(*this);
+    midiDispatcher.prepare(juce::jmax(256, samplesPerBlock));
+
     for (int n = 0; n < NUM_SAMPLERS; n++)
         sampler[n].setCurrentPlaybackSampleRate(devSampleRate);
 
-    initFilters();
-    
-    midiCollector.reset(devSampleRate);
+    rcFilter.initFilters(devSampleRate);
 
     init = false;
 }
@@ -195,73 +206,63 @@ bool AmiAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) cons
 void AmiAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+
+    // odd while a block is running; see AmiSampleReclaimer
+    ++renderEpoch;
+
     int totalNumInputChannels  = getTotalNumInputChannels();
     int totalNumOutputChannels = getTotalNumOutputChannels();
 
-    const float* sampReadL = buffer.getReadPointer(0);
-    const float* sampReadR = totalNumOutputChannels > 1 ? buffer.getReadPointer(1) : nullptr;
-
     float* sampWriteL = buffer.getWritePointer(0);
     float* sampWriteR = totalNumOutputChannels > 1 ? buffer.getWritePointer(1) : nullptr;
 
-    int numSamples = buffer.getNumSamples();
-
-    midiBuffer = midiMessages;
-    midiCollector.removeNextBlockOfMessages(midiBuffer, buffer.getNumSamples());
+    const int numSamples = buffer.getNumSamples();
 
+    // the on-screen keyboard's notes are merged into the host's here
     keyState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(), true);
     
     hostIsPlaying = getPlayHead()->getPosition()->getIsPlaying();
     
-    if (!midiBuffer.isEmpty())
-    {
-        for (int i = 0; i < midiBuffer.data.size() - 2; i++)
-        {
-            if (i == 6 && (midiBuffer.data.operator[](i) & 0xB0) == 0xB0)
-            {
-                if (midiBuffer.data.operator[](i + 1) == 1)
-                {
-                    modIntensity = midiBuffer.data.operator[](i + 2);
-                    setAVPTSvalue("VIBRATO INTENSITY", modIntensity);
-                    break;
-                }
-            }
-        }
-    }
-
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    for (int n = 0; n < NUM_SAMPLERS; n++)
-        sampler[n].renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    midiDispatcher.updateRouting(NUM_SAMPLERS, sampleMidiChannel, midiLowNote, midiHiNote);
+
+    // hosts may send a bigger block than promised in prepareToPlay, so the slots
+    // are rendered in pieces no longer than the vibrato buffer rather than
+    // growing it here; the last piece also takes any MIDI timed past the end
+    const int maxPiece = vibratoBuffer.getNumSamples();
+
+    jassert(maxPiece > 0);
 
-    while (--numSamples >= 0)
+    for (int start = 0; maxPiece > 0 && start < numSamples; start += maxPiece)
     {
-        float l = *sampReadL++, 
-              r = sampReadR == nullptr ? l : *sampReadR++;
+        const int length = juce::jmin(maxPiece, numSamples - start);
+        const bool lastPiece = start + length >= numSamples;
 
-        float outL = 0, outR = 0;
+        juce::AudioBuffer<float> piece(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, length);
 
-        incVibratoTable();
+        midiDispatcher.parseBlock(midiMessages, start, lastPiece ? std::numeric_limits<int>::max() : start + length);
 
-        getAmiFilter(&l, &r, &outL, &outR);
+        renderVibrato(length);
 
-        outL *= masterVol;
-        outR *= masterVol;
-  
-        if (sampReadR == nullptr)
-        {
-            *sampWriteL++ = (outL + outR) * 0.5f;
-        }
-        else
-        {
-            outL *= masterPanL;
-            outR *= masterPanR;
+        midiDispatcher.renderSlots(sampler, NUM_SAMPLERS, piece, length);
+    }
 
-            *sampWriteL++ = outL;
-            *sampWriteR++ = outR;
-        }
+    rcFilter.setModel(isA500, ledFilterOn);
+    rcFilter.processBlock(sampWriteL, sampWriteR, numSamples);
+
+    if (sampWriteR == nullptr)
+    {
+        juce::FloatVectorOperations::multiply(sampWriteL, masterVol, numSamples);
     }
+    else
+    {
+        juce::FloatVectorOperations::multiply(sampWriteL, masterVol * masterPanL, numSamples);
+        juce::FloatVectorOperations::multiply(sampWriteR, masterVol * masterPanR, numSamples);
+    }
+
+    ++renderEpoch;
 }
 
 //==============================================================================
@@ -278,16 +279,37 @@ juce::AudioProcessorEditor* AmiAudioProcessor::createEditor()
 //==============================================================================
 void AmiAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
+    const AmiStateFormat::SampleChunk_t* chunks[NUM_SAMPLERS];
+
     juce::ValueTree state = APVTS.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+
+    // only slots whose samples changed since the last save get encoded again
+    const juce::ScopedLock sl(sampleStore.getLock());
+
+    // streamed slots only keep an overview, and are restored from their file instead
+    for (int i = 0; i < NUM_SAMPLERS; i++)
+        chunks[i] = &sampleStore.getChunk(i, waveForm[i] != nullptr && waveForm[i]->isOverview() ? AmiSampleBuffer::getEmptyBuffer() 
+                                                                                                   : getWaveForm(i));
+
+    AmiStateFormat::write(state, chunks, NUM_SAMPLERS, destData);
 }
 
 void AmiAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+    juce::ValueTree state;
+    AmiStateFormat::SampleChunk_t chunks[NUM_SAMPLERS];
 
-    if (xmlState.get() == nullptr)
+    const bool binaryState = AmiStateFormat::read(data, sizeInBytes, state, chunks, NUM_SAMPLERS);
+
+    if (!binaryState)
+    {
+        // states saved by 1.3 and earlier are XML, with the samples base64 encoded in the tree
+        std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
+
+        if (xmlState.get() != nullptr) state = juce::ValueTree::fromXml(*xmlState);
+    }
+
+    if (!state.isValid())
     {
         currentSample = 0;
         init = false;
@@ -297,39 +319,59 @@ void AmiAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
     
     init = true;
     
-    if (xmlState->hasTagName(APVTS.state.getType()))
+    if (state.hasType(APVTS.state.getType()))
     {
-        APVTS.replaceState(juce::ValueTree::fromXml(*xmlState));
+        std::unique_ptr<RestoredSlot_t[]> restored = std::make_unique<RestoredSlot_t[]>(NUM_SAMPLERS);
+
+        APVTS.replaceState(state);
 
         for (int i = 0; i < NUM_SAMPLERS; i++)
         {
-            juce::String path = APVTS.state.getProperty("pathname" + juce::String(i)).toString();
-            juce::MemoryBlock waveformData;
+            RestoredSlot_t& slot = restored[i];
+            const juce::Identifier waveformID("waveformdata" + juce::String(i));
 
-            currentSample = i;
+            // decoding below needs to know whether to stream, ahead of the parameters being replayed
+            diskStream[i] = (int) APVTS.getRawParameterValue("DISK STREAM" + juce::String(i))->load();
 
             sourceSampleRate[i] = APVTS.state.getProperty("samplerate" + juce::String(i)).operator double();
             if(sourceSampleRate[i] <= 0 || sourceSampleRate[i] > 96000.0) sourceSampleRate[i] = 16726.0;
 
-            if(waveformData.fromBase64Encoding(APVTS.state.getProperty("waveformdata" + juce::String(i)).toString()))
+            slot.name = APVTS.state.getProperty("samplename" + juce::String(i)).toString();
+            slot.path = APVTS.state.getProperty("pathname" + juce::String(i)).toString();
+
+            if (binaryState)
+                slot.chunk = std::move(chunks[i]);
+            else
+                slot.waveformData = APVTS.state.getProperty(waveformID).toString();
+
+            APVTS.state.removeProperty(waveformID, nullptr);
+        }
+
+        // decode and quantize every slot at once, then publish them all from here
+        sampleLoader.runParallel(NUM_SAMPLERS, [this, &restored, binaryState](int i) { restoreSlot(restored[i], i, binaryState); });
+
+        for (int i = 0; i < NUM_SAMPLERS; i++)
+        {
+            RestoredSlot_t& slot = restored[i];
+
+            currentSample = i;
+
+            if (slot.samples != nullptr)
             {
-                const int sampleLength = (int) (waveformData.getSize() / sizeof(float));
-                
-                waveForm[i].setSize(1, sampleLength);
-                waveForm[i].copyFrom(0, 0, (float*) waveformData.getData(), sampleLength);
-
-                sampler[i].clearSounds();
-                sampler[i].addSound(new AmiSamplerSound(sampleName[i], i, waveForm[i],  
-                    sourceSampleRate[i], voiceRange, 60, 0.1, 0.1, *this));
+                setWaveForm(i, slot.samples);
+
+                // the chunk we just read is already what the next save would write
+                if (binaryState) sampleStore.setChunk(i, std::move(slot.chunk));
+
+                setSampleSound(i, slot.sound.get());
                     
-                sampleName[i] = APVTS.state.getProperty("samplename" + juce::String(i)).toString();
+                sampleName[i] = slot.name;
                 pingpongLoop[i] = APVTS.state.getProperty("pingpongLoop" + juce::String(i)).operator int();
             }
-            else if (path.isNotEmpty()) // for backwards compatibility, v0.6 recalled samples from path instead of storing data in APVTS state
+            else if (slot.path.isNotEmpty())
             {
-                loadFile(path);
+                applyLoadedSample(slot.fromFile);
             }
-
         }
 
         for(int i = 0; i < APVTS.state.getNumChildren(); i++)
@@ -345,21 +387,44 @@ void AmiAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
     init = false;
 }
 
-void AmiAudioProcessor::handleNoteOn(juce::MidiKeyboardState* source, int midiChannel, int midiNoteNumber, float velocity)
+void AmiAudioProcessor::restoreSlot(RestoredSlot_t& slot, const int i, const bool binaryState)
 {
-    auto m = juce::MidiMessage::noteOn(midiChannel, midiNoteNumber, velocity);
+    juce::AudioBuffer<float> samples;
+    bool hasData = false;
 
-    if (source->isNoteOn(midiChannel, midiNoteNumber)) return;
+    if (binaryState)
+    {
+        hasData = AmiStateFormat::decodeChunk(slot.chunk, samples);
+    }
+    else
+    {
+        juce::MemoryBlock waveformData;
 
-    m.setTimeStamp(juce::Time::getMillisecondCounterHiRes() * 0.001);
-    midiCollector.addMessageToQueue(m);
-}
+        if (waveformData.fromBase64Encoding(slot.waveformData))
+        {
+            const int sampleLength = (int) (waveformData.getSize() / sizeof(float));
 
-void AmiAudioProcessor::handleNoteOff(juce::MidiKeyboardState* /*source*/, int midiChannel, int midiNoteNumber, float velocity)
-{
-    auto m = juce::MidiMessage::noteOff(midiChannel, midiNoteNumber, velocity);
-    m.setTimeStamp(juce::Time::getMillisecondCounterHiRes() * 0.001);
-    midiCollector.addMessageToQueue(m);
+            samples.setSize(1, sampleLength);
+            samples.copyFrom(0, 0, (float*) waveformData.getData(), sampleLength);
+
+            hasData = true;
+        }
+
+        slot.waveformData = {};
+    }
+
+    if (hasData)
+    {
+        slot.samples = new AmiSampleBuffer(std::move(samples));
+        slot.sound = new AmiSamplerSound(slot.name, i, slot.samples,
+                                         sourceSampleRate[i], voiceRange, 60, 0.1, 0.1, *this);
+    }
+    else if (slot.path.isNotEmpty()) // for backwards compatibility, v0.6 recalled samples from path instead of storing data in APVTS state
+    {
+        slot.fromFile.slot = i;
+        slot.fromFile.file = juce::File(slot.path);
+        slot.fromFile.succeeded = sampleLoader.decode(slot.fromFile, nullptr, -1);
+    }
 }
 
 bool AmiAudioProcessor::saveFile(juce::File &file)
@@ -367,6 +432,8 @@ bool AmiAudioProcessor::saveFile(juce::File &file)
     juce::StringPairArray metaData = NULL;
     std::unique_ptr<juce::AudioFormatWriter> writer = nullptr;
 
+    juce::AudioBuffer<float> streamed;
+
     if(file.getFileName().isEmpty()) return true;
 
     lastFileDir = file.getParentDirectory().getFullPathName();
@@ -386,7 +453,7 @@ bool AmiAudioProcessor::saveFile(juce::File &file)
         }
 
         writer.reset(wavFormat.createWriterFor(new juce::FileOutputStream(file.withFileExtension("wav")),
-            sourceSampleRate[currentSample], (uint_least32_t) waveForm[currentSample].getNumChannels(), 8, metaData, 0));
+            sourceSampleRate[currentSample], (uint_least32_t) getWaveForm(currentSample).getNumChannels(), 8, metaData, 0));
     }
 
     else if (file.hasFileExtension(".iff") || file.hasFileExtension(".8svx"))
@@ -422,13 +489,15 @@ bool AmiAudioProcessor::saveFile(juce::File &file)
         juce::AiffAudioFormat aifFormat;
 
         writer.reset(aifFormat.createWriterFor(new juce::FileOutputStream(file),
-            sourceSampleRate[currentSample], (uint32_t) waveForm[currentSample].getNumChannels(), 8, NULL, 0));
+            sourceSampleRate[currentSample], (uint32_t) getWaveForm(currentSample).getNumChannels(), 8, NULL, 0));
     }
 
     if (writer != nullptr && (file.hasFileExtension(".wav") || file.hasFileExtension(".aif") || file.hasFileExtension(".bin") ||
         file.hasFileExtension(".iff") || file.hasFileExtension(".raw") || file.hasFileExtension(".smp") || file.hasFileExtension("")))
     {
-        writer->writeFromAudioSampleBuffer(waveForm[currentSample], 0, waveForm[currentSample].getNumSamples());
+        const juce::AudioBuffer<float>& samples = getFullWaveForm(currentSample, streamed);
+
+        writer->writeFromAudioSampleBuffer(samples, 0, samples.getNumSamples());
         return true;
     }
     
@@ -475,171 +544,221 @@ void AmiAudioProcessor::buttonLoadFile(std::function<void (const juce::FileChoos
 
 bool AmiAudioProcessor::loadFile(const juce::String& path)
 {
-    juce::AudioFormatReader* formatReader = nullptr;
-    AmiSamplerSound* sampleSound = nullptr;
+    AmiSampleLoader::LoadResult_t result;
 
-    std::unique_ptr<juce::MemoryBlock> waveformData = nullptr;
-    juce::StringPairArray metaData = NULL;
+    result.slot = currentSample;
+    result.file = juce::File(path);
+    result.succeeded = sampleLoader.decode(result, nullptr, -1);
+
+    applyLoadedSample(result);
 
-    juce::File file = juce::File(path);
+    return result.succeeded;
+}
 
-    int sampleLength = 0, fileLoopEnable = 0, fileLoopStart = 0, fileLoopEnd = 0;
+void AmiAudioProcessor::applyLoadedSample(AmiSampleLoader::LoadResult_t& result)
+{
+    const int slot = result.slot;
+    const juce::File& file = result.file;
 
     lastFileDir = file.getParentDirectory().getFullPathName();
 
     if ((!file.exists() || file.getSize() <= 0))
     {
-        sampler[currentSample].clearSounds();
-        return false;
+        setSampleSound(slot, nullptr);
+        return;
     }
 
-    APVTS.state.setProperty(juce::Identifier("pathname" + juce::String(currentSample)), path, nullptr);
+    APVTS.state.setProperty(juce::Identifier("pathname" + juce::String(slot)), file.getFullPathName(), nullptr);
 
-    sampleName[currentSample] = file.getFileNameWithoutExtension();
-    APVTS.state.setProperty(juce::Identifier("samplename" + juce::String(currentSample)), sampleName[currentSample], nullptr);
+    sampleName[slot] = file.getFileNameWithoutExtension();
+    APVTS.state.setProperty(juce::Identifier("samplename" + juce::String(slot)), sampleName[slot], nullptr);
 
-    formatReader = formatManager.createReaderFor(file);
+    if (!result.succeeded) return;
 
-    if(formatReader == nullptr) return false;
+    setWaveForm(slot, result.data);
 
-    if((sampleLength = (int) (formatReader->lengthInSamples)) <= 1) 
-    {
-        delete formatReader;
-        return false;
-    }
-    
-    waveForm[currentSample].setSize(1, sampleLength);
-    formatReader->read(&waveForm[currentSample], 0, sampleLength, 0, true, false);
-
-    waveformData = std::make_unique<juce::MemoryBlock>((void*) waveForm[currentSample].getReadPointer(0), (size_t) sampleLength * sizeof *waveForm[currentSample].getReadPointer(0));
-    APVTS.state.setProperty(juce::Identifier("waveformdata" + juce::String(currentSample)), waveformData->toBase64Encoding(), nullptr);
-    
-    sampler[currentSample].clearSounds();
-    sampleSound = new AmiSamplerSound(sampleName[currentSample], currentSample, waveForm[currentSample],  
-                                        formatReader->sampleRate, voiceRange, 60, 0.1, 0.1, *this);
-
-    setSamplerEnvelopes(currentSample, sampleSound);
-
-    sampler[currentSample].addSound(sampleSound);
+    setSamplerEnvelopes(slot, result.sound.get());
 
-    setSourceSampleRate(currentSample, formatReader->sampleRate);
+    setSampleSound(slot, result.sound.get());
 
-    if (init) 
-    {
-        delete formatReader;
-        return true;
-    }
-
-    metaData = formatReader->metadataValues;
+    setSourceSampleRate(slot, result.sampleRate);
 
-    if (metaData.containsKey("Loop0Start") && metaData.containsKey("Loop0End"))
-    {
-        fileLoopEnable = 1;
-        fileLoopStart = metaData.getValue("Loop0Start", "int").getIntValue();
-        fileLoopEnd = metaData.getValue("Loop0End", "int").getIntValue() + 1;
-    }
+    if (init || result.keepSettings) return;
 
-    if (!fileLoopEnable || fileLoopStart == fileLoopEnd || fileLoopEnd <= 0)
+    if (!result.hasLoop || result.loopStart == result.loopEnd || result.loopEnd <= 0)
     {
-        setLoopEnable(currentSample, 0);
-        setLoopStart(currentSample, 0);
-        setLoopEnd(currentSample, waveForm[currentSample].getNumSamples());
+        setLoopEnable(slot, 0);
+        setLoopStart(slot, 0);
+        setLoopEnd(slot, getSampleLength(slot));
     }
     else
     {
-        setLoopEnable(currentSample, 1);
-        setLoopStart(currentSample,fileLoopStart);
-        setLoopEnd(currentSample, fileLoopEnd);
+        setLoopEnable(slot, 1);
+        setLoopStart(slot, result.loopStart);
+        setLoopEnd(slot, result.loopEnd);
     }
-    
-    delete formatReader;
-    return true;
 }
 
 void AmiAudioProcessor::setNumVoices(const int i)
 {
-    const int newNumVoices = numVoices[i] == 1 ? 1 : numVoices[i] == 2 ? 4 : 8;
+    sampler[i].setVoiceLimit(numVoices[i] == 1 ? 1 : numVoices[i] == 2 ? 4 : 8);
+}
 
-    if (newNumVoices == sampler[i].getNumVoices()) return;
+void AmiAudioProcessor::setWaveForm(const int i, AmiSampleBuffer::Ptr samples)
+{
+    waveForm[i] = samples;
+    sampleStore.markDirty(i);
+}
 
-    sampler[i].clearVoices();
+void AmiAudioProcessor::setSampleSound(const int i, juce::SynthesiserSound* sound)
+{
+    if (AmiSamplerSound* ami = dynamic_cast<AmiSamplerSound*>(sound))
+        diskStreamer.addStream(ami->getStream());
 
-    for (int n = 0; n < newNumVoices; n++)
-        sampler[i].addVoice(new AmiSamplerVoice(*this));
+    sampleReclaimer.retire(sampler[i].swapSound(sound));
 }
 
-void AmiAudioProcessor::incVibratoTable()
+void AmiAudioProcessor::renderVibrato(const int numSamples)
 {
-    const double vibeFreq = (vibeSpeed * 32.) / devSampleRate;
-    const int vibePos = (int)std::floor(vibeRate);
+    jassert(numSamples <= vibratoBuffer.getNumSamples());
+
+    float* vibrato = vibratoBuffer.getWritePointer(0);
+
+    const juce::Array<AmiMidiDispatcher::ModEvent_t>& modWheel = midiDispatcher.getModWheelEvents();
+    int nextEvent = 0;
+
+    // the mod wheel sets the vibrato depth from its own sample offset onwards
+    for (int start = 0; start < numSamples;)
+    {
+        while (nextEvent < modWheel.size() && modWheel.getReference(nextEvent).samplePosition <= start)
+            modIntensity = modWheel.getReference(nextEvent++).value;
+
+        const int end = nextEvent < modWheel.size() ? juce::jmin(numSamples, modWheel.getReference(nextEvent).samplePosition) 
+                                                    : numSamples;
 
-    if (modIntensity == 0) { vibeRatio = 1.; return; }
+        renderVibratoSegment(vibrato + start, end - start);
+        start = end;
+    }
 
-    vibeRatio = 1.f + ((float) (128 - vibratoTable[vibePos]) * (float) modIntensity) / 409600.f;
+    while (nextEvent < modWheel.size())
+        modIntensity = modWheel.getReference(nextEvent++).value;
 
-    vibeRate += vibeFreq;
-    if (vibeRate >= 32.) vibeRate = 0.;
+    // let the host and GUI know about the new depth without running a gesture on the audio thread
+    if (modWheel.size() > 0)
+        parameterFeedback.push(vibratoIntensityParam, (float) modIntensity);
 }
 
-void AmiAudioProcessor::resampleAudioData(const int chan, const double newRate)
+void AmiAudioProcessor::renderVibratoSegment(float* vibrato, const int numSamples)
 {
-    std::unique_ptr<juce::MemoryBlock> waveformData = nullptr;
-    
-    std::unique_ptr<juce::AudioSampleBuffer>newSampleData = std::make_unique<juce::AudioSampleBuffer>();
-    juce::AudioSampleBuffer* sampleData = &waveForm[chan];
+    if (modIntensity == 0) 
+    { 
+        juce::FloatVectorOperations::fill(vibrato, 1.f, numSamples);
+        return;
+    }
 
-    AmiSamplerSound* sampleSound = nullptr;
+    const double vibeFreq = (vibeSpeed * 32.) / devSampleRate;
+    const float depth = (float) modIntensity / 409600.f;
 
-    const double sourceRate = sourceSampleRate[chan], resampleRatio = sourceRate / newRate;
-    const int sourceSampleLength = sampleData->getNumSamples(), 
-              newSampleLength    = (int) std::floor((double) sourceSampleLength / resampleRatio);
+    for (int i = 0; i < numSamples; i++)
+    {
+        const int vibePos = (int) std::floor(vibeRate);
+
+        vibrato[i] = 1.f + (float) (128 - vibratoTable[vibePos]) * depth;
 
-    double resamplePos = 0.0;
+        vibeRate += vibeFreq;
+        if (vibeRate >= 32.) vibeRate = 0.;
+    }
+}
+
+void AmiAudioProcessor::timerCallback()
+{
+    parameterFeedback.flush();
 
-    newSampleData->setSize(1, newSampleLength);
+    sampleLoader.deliverFinished([this](AmiSampleLoader::LoadResult_t& result) { applyLoadedSample(result); });
 
-    for(int i = 0; i < newSampleLength; i++)
+    // octave pyramids are only built once a voice has asked for one
+    for (int n = 0; n < NUM_SAMPLERS; n++)
     {
-        const int pos = (int) std::floor(resamplePos);
+        juce::SynthesiserSound::Ptr sound = sampler[n].getCurrentSound();
+
+        AmiSamplerSound* ami = dynamic_cast<AmiSamplerSound*>(sound.get());
 
-        newSampleData->setSample(0, i, sampleData->getSample(0, pos));
+        if (ami == nullptr) continue;
 
-        resamplePos += resampleRatio;
+        if (ami->claimPyramidRequest())
+            sampleLoader.runInBackground([sound] { static_cast<AmiSamplerSound*>(sound.get())->buildPyramid(); });
 
-        if(resamplePos >= sourceSampleLength || resamplePos >= waveForm[chan].getNumSamples()) 
+        const int start = loopStart[n], end = loopEnd[n];
+        const bool pingPong = pingpongLoop[n] != 0;
+
+        // keep a streamed slot's loop region in memory, following its loop points
+        if (AmiSampleStream* stream = ami->getStream())
         {
-            // fill remaining samples
-            for(int n = i; n < newSampleLength; n++)
-            {
-                newSampleData->setSample(0, n, sampleData->getSample(0, pos));
-            }
+            sampleReclaimer.retire(stream->publishLoopRegion());
 
-            break;
+            if (loopEnable[n] && stream->claimLoopLoad(start, end, pingPong))
+                sampleLoader.runInBackground([sound, start, end, pingPong] 
+                {
+                    static_cast<AmiSamplerSound*>(sound.get())->getStream()->loadLoopRegion(start, end, pingPong);
+                });
+        }
+        else
+        {
+            // and an in-memory one's loop unrolled, following its loop points and hold
+            sampleReclaimer.retire(ami->publishUnrolledLoop());
+
+            if (loopEnable[n] && ami->claimLoopUnroll(start, end, pingPong))
+                sampleLoader.runInBackground([sound, start, end, pingPong]
+                {
+                    static_cast<AmiSamplerSound*>(sound.get())->unrollLoop(start, end, pingPong);
+                });
         }
     }
-    
-    waveForm[chan].clear();
-    waveForm[chan].setSize(1, newSampleLength);
-    waveForm[chan].makeCopyOf(*newSampleData);
 
-    waveformData = std::make_unique<juce::MemoryBlock>((void*) newSampleData->getReadPointer(0), (size_t) newSampleLength * sizeof *newSampleData->getReadPointer(0));
-    APVTS.state.setProperty(juce::Identifier("waveformdata" + juce::String(chan)), waveformData->toBase64Encoding(), nullptr);
+    // totalled here for getStreamUnderruns()
+    streamUnderruns += diskStreamer.takeUnderruns();
+}
+
+const juce::AudioBuffer<float>& AmiAudioProcessor::getFullWaveForm(const int i, juce::AudioBuffer<float>& scratch)
+{
+    AmiSamplerSound* sound = dynamic_cast<AmiSamplerSound*>(sampler[i].getCurrentSound());
+
+    if (sound == nullptr || sound->getStream() == nullptr) return getWaveForm(i);
+
+    if (!sound->getStream()->readAll(scratch)) scratch.setSize(1, 0);
+
+    return scratch;
+}
+
+void AmiAudioProcessor::resampleAudioData(const int chan, const double newRate, const AmiResampler::Quality quality)
+{
+    // a streamed slot is read back in full; the result is held in memory like any resampled slot
+    juce::AudioSampleBuffer streamed;
+    const juce::AudioSampleBuffer& sampleData = getFullWaveForm(chan, streamed);
+
+    AmiSamplerSound* sampleSound = nullptr;
+
+    const double sourceRate = sourceSampleRate[chan], resampleRatio = sourceRate / newRate;
+    const int sourceSampleLength = sampleData.getNumSamples(), 
+              newSampleLength    = (int) std::floor((double) sourceSampleLength / resampleRatio);
+
+    // the new samples are built aside on the loader's pool and swapped in whole
+    juce::AudioSampleBuffer newSampleData = AmiResampler::process(sampleData, resampleRatio, newSampleLength, 
+                                                                  quality, sampleLoader);
+    
+    setWaveForm(chan, new AmiSampleBuffer(std::move(newSampleData)));
      
     setSourceSampleRate(chan, newRate);
 
-    sampler[chan].clearSounds();
-
     sampleSound = new AmiSamplerSound(sampleName[chan], chan, waveForm[chan],  
                     sourceSampleRate[chan], voiceRange, 60, 0.1, 0.1, *this);
 
     setSamplerEnvelopes(chan, sampleSound);
 
-    sampler[chan].addSound(sampleSound);
+    setSampleSound(chan, sampleSound);
                     
     setLoopStart(chan, (int) std::floor((double) loopStart[chan] / resampleRatio));
     setLoopEnd(chan, (int) std::floor((double) loopEnd[chan] / resampleRatio));
-
-    newSampleData->clear();
 }
 
 void AmiAudioProcessor::setSamplerEnvelopes(const int i, void* sound)
@@ -657,74 +776,6 @@ void AmiAudioProcessor::setSamplerEnvelopes(const int i, void* sound)
     sampleSound->setEnvelopeParameters(adsrParams);
 }
 
-void AmiAudioProcessor::initFilters()
-{
-    double  R  = 0., C  = 0.,
-            R1 = 0., R2 = 0., 
-            C1 = 0., C2 = 0., 
-            cutoff  = 0., 
-            qfactor = 0.;
-
-    const double twoPi = juce::MathConstants<double>::twoPi;
-
-    rcFilter.clearOnePoleFilterState(&a500FilterLo);
-
-    rcFilter.clearOnePoleFilterState(&a500FilterHi);
-
-    rcFilter.clearOnePoleFilterState(&a1200FilterHi);
-
-    rcFilter.clearTwoPoleFilterState(&filterLED);
-
-    R = 360.0; // R321 (360 ohm)
-    C = 1e-7;  // C321 (0.1uF)
-    cutoff = 1.0 / (twoPi * R * C); // ~4420.971Hz
-    rcFilter.setupOnePoleFilter(devSampleRate, cutoff, &a500FilterLo);
-
-    // A500 1-pole (6dB/oct) RC high-pass filter:
-    R = 1390.0;   // R324 (1K ohm) + R325 (390 ohm)
-    C = 2.233e-5; // C334 (22uF) + C335 (0.33uF)
-    cutoff = 1.0 / (twoPi * R * C); // ~5.128Hz
-    rcFilter.setupOnePoleFilter(devSampleRate, cutoff, &a500FilterHi);
-
-    // A1200 1-pole (6dB/oct) RC high-pass filter:
-    R = 1360.0; // R324 (1K ohm resistor) + R325 (360 ohm resistor)
-    C = 2.2e-5; // C334 (22uF capacitor)
-    cutoff = 1.0 / (twoPi * R * C); // ~5.319Hz
-    rcFilter.setupOnePoleFilter(devSampleRate, cutoff, &a1200FilterHi);
-
-    R1 = 10000.0; // R322 (10K ohm)
-    R2 = 10000.0; // R323 (10K ohm)
-    C1 = 6.8e-9;  // C322 (6800pF)
-    C2 = 3.9e-9;  // C323 (3900pF)
-    cutoff = 1.0 / (twoPi * std::sqrt(R1 * R2 * C1 * C2)); // ~3090.533Hz
-    qfactor = std::sqrt(R1 * R2 * C1 * C2) / (C2 * (R1 + R2)); // ~0.660225
-    rcFilter.setupTwoPoleFilter(devSampleRate, cutoff, qfactor, &filterLED);
-}
-
-void AmiAudioProcessor::getAmiFilter(const float* inL, const float* inR, float* outL, float* outR)
-{
-    float filteredL = 0.f;
-    float filteredR = 0.f;
-
-    jassert(inL != nullptr && inR != nullptr && outL != nullptr && outR != nullptr);
-
-    if (isA500)
-    {
-        rcFilter.onePoleLPFilter(&a500FilterLo, inL, inR, &filteredL, &filteredR);
-        rcFilter.onePoleHPFilter(&a500FilterHi, &filteredL, &filteredR, &filteredL, &filteredR);
-    }
-    else
-    {
-        rcFilter.onePoleHPFilter(&a1200FilterHi, inL, inR, &filteredL, &filteredR);
-    }
-
-    if( ledFilterOn )
-        rcFilter.twoPoleLPFilter(&filterLED, &filteredL, &filteredR, &filteredL, &filteredR);
-
-    *outL = filteredL;
-    *outR = filteredR;
-}
-
 std::unique_ptr<juce::AudioParameterInt> AmiAudioProcessor::createParam(const juce::String& name, const int min, const int max, const int def)
 {
     return std::make_unique<juce::AudioParameterInt>(juce::ParameterID{ name.toUpperCase(), 1 }, name, min, max, def);
@@ -771,6 +822,13 @@ juce::AudioProcessorValueTreeState::ParameterLayout AmiAudioProcessor::createPar
         parameters.add(createParam("Decay" + sampleParam, 0.0f, 4.0f, 0.0625f, 0.0f));
         parameters.add(createParam("Sustain" + sampleParam, 0.0f, 1.0f, 0.015625f, 1.0f));
         parameters.add(createParam("Release" + sampleParam, 0.001f, 5.0f, 0.078125f, 0.001f));
+
+        // 0 nearest (the original point sampling), 1 linear, 2 cubic, 3 windowed sinc,
+        // 4 Paula (held samples with band-limited steps)
+        parameters.add(createParam("Interpolation" + sampleParam, 0, AmiVoiceBank::numInterpolationModes - 1, 0));
+
+        // long samples play from their file, applied by reloading the slot
+        parameters.add(createParam("Disk Stream" + sampleParam, 0, 1, 0));
     }
 
     parameters.add(createParam("Master Volume", 0.f, 64.f, 1.f, 32.f));
@@ -782,167 +840,164 @@ juce::AudioProcessorValueTreeState::ParameterLayout AmiAudioProcessor::createPar
     parameters.add(createParam("LED Filter", 0, 1, 0));
     parameters.add(createParam("Model Type", 0, 1, 0));
 
+    parameters.add(createParam("Polyphony", 1, AmiVoicePool::maxVoices, AmiVoicePool::maxVoices));
+
     return { parameters.begin(), parameters.end() };
 }
 
-void AmiAudioProcessor::valueTreePropertyChanged(juce::ValueTree& treeWhosePropertyHasChanged, const juce::Identifier& property)
+void AmiAudioProcessor::buildParamTargets()
 {
-    const juce::String changedParam = treeWhosePropertyHasChanged.getProperty(treeWhosePropertyHasChanged.getPropertyName(0)).toString();
-    const juce::var paramVal = treeWhosePropertyHasChanged.getProperty(property);
+    const juce::String globalIds[] = { "MASTER VOLUME", "MASTER PAN", "LED FILTER", "MODEL TYPE", "POLYPHONY",
+                                       "VIBRATO SPEED", "VIBRATO INTENSITY" };
 
-    if(changedParam.compare("MASTER VOLUME") == 0)
-    {
-        masterVol = (float) (std::pow(paramVal.operator float(), 2) /std::pow(64, 2));
-        return;
-    }
+    const juce::String sampleIds[] = { "CHANNEL VOLUME", "SAMPLE MIDI CHAN", "SAMPLE ROOT NOTE", "SAMPLE LOW NOTE",
+                                       "SAMPLE HIGH NOTE", "SAMP N HOLD", "LOOP ENABLE", "LOOP START", "LOOP END",
+                                       "MONO POLY", "PAULA STEREO", "CHANNEL GLISS", "FINE TUNE", "MUTE", "SOLO",
+                                       "CHANNEL PAN", "CHANNEL WIDTH", "ATTACK", "DECAY", "SUSTAIN", "RELEASE",
+                                       "INTERPOLATION", "DISK STREAM" };
 
-    if(changedParam.compare("MASTER PAN") == 0)
-    {
-        const float pan = paramVal.operator float();
+    static_assert(sizeof(globalIds) / sizeof(globalIds[0]) == firstSampleParam, "one ID per global field");
+    static_assert(sizeof(sampleIds) / sizeof(sampleIds[0]) == numParamFields - firstSampleParam, "one ID per sample field");
 
-        masterPanL = pan <= 128 ? 1.f : std::abs(pan - 255) / 127;
-        masterPanR = pan >= 128 ? 1.f : pan / 127;
-        return;
-    }
+    paramTargets.clear();
+    paramTargets.reserve((size_t) (firstSampleParam + (numParamFields - firstSampleParam) * NUM_SAMPLERS));
 
-    if(changeValueTreeParam(changedParam, "LED FILTER", paramVal, &ledFilterOn)) return;
-    if(changeValueTreeParam(changedParam, "MODEL TYPE", paramVal, &isA500)) return;
-        
-    if(changeValueTreeParam(changedParam, "VIBRATO SPEED", paramVal, &vibeSpeed)) return;
-    if(changeValueTreeParam(changedParam, "VIBRATO INTENSITY", paramVal, &modIntensity)) return;
-  
-    for(int n = 0; n < NUM_SAMPLERS; n++)
-    {
-        const juce::String sampleParam = juce::String(n);
-        
-        if(changedParam.compare("CHANNEL VOLUME" + sampleParam) == 0)
-        {
-            channelVolume[n] = (float) (std::pow(paramVal.operator float(), 2)/std::pow(64, 2));
-            return;
-        }
+    for (int f = 0; f < firstSampleParam; f++)
+        paramTargets[globalIds[f]] = { (ParamField) f, -1 };
 
-        if(changeValueTreeParam(changedParam, "SAMPLE MIDI CHAN" + sampleParam, paramVal, &sampleMidiChannel[n])) return;
-        if(changeValueTreeParam(changedParam, "SAMPLE ROOT NOTE" + sampleParam, paramVal, &midiRootNote[n])) return;
-        if(changeValueTreeParam(changedParam, "SAMPLE LOW NOTE" + sampleParam, paramVal, &midiLowNote[n])) return;
-        if(changeValueTreeParam(changedParam, "SAMPLE HIGH NOTE" + sampleParam, paramVal, &midiHiNote[n])) return;
+    for (int n = 0; n < NUM_SAMPLERS; n++)
+        for (int f = firstSampleParam; f < numParamFields; f++)
+            paramTargets[sampleIds[f - firstSampleParam] + juce::String(n)] = { (ParamField) f, n };
+}
 
-        if(changeValueTreeParam(changedParam, "SAMP N HOLD" + sampleParam, paramVal, &snh[n])) return;
+void AmiAudioProcessor::valueTreePropertyChanged(juce::ValueTree& treeWhosePropertyHasChanged, const juce::Identifier& property)
+{
+    const juce::String changedParam = treeWhosePropertyHasChanged.getProperty(treeWhosePropertyHasChanged.getPropertyName(0)).toString();
 
-        if(changeValueTreeParam(changedParam, "LOOP ENABLE" + sampleParam, paramVal, &loopEnable[n])) return;
-        if(changeValueTreeParam(changedParam, "LOOP START" + sampleParam, paramVal, &loopStart[n])) return;
-        if(changeValueTreeParam(changedParam, "LOOP END" + sampleParam, paramVal, &loopEnd[n])) return;
+    const auto target = paramTargets.find(changedParam);
 
-        if(changeValueTreeParam(changedParam, "MONO POLY" + sampleParam, paramVal, &numVoices[n])) 
-        {
-            setNumVoices(n);
-            return;
-        }
+    if (target == paramTargets.end()) return;
 
-        if(changeValueTreeParam(changedParam, "PAULA STEREO" + sampleParam, paramVal, &paulaStereo[n])) 
-        {
-            channelPan[n].store(APVTS.getRawParameterValue((paulaStereo[n] ? "CHANNEL WIDTH" : "CHANNEL PAN") + sampleParam)->load());
-            return;
-        }
+    applyParam(target->second, treeWhosePropertyHasChanged.getProperty(property));
+}
 
-        if(changeValueTreeParam(changedParam, "CHANNEL GLISS" + sampleParam, paramVal, &channelGliss[n])) return;
-        if(changeValueTreeParam(changedParam, "FINE TUNE" + sampleParam, paramVal, &tune[n])) return;
+void AmiAudioProcessor::applyParam(const ParamTarget_t& target, const juce::var& paramVal)
+{
+    const int n = target.slot;
 
-        if(changeValueTreeParam(changedParam, "MUTE" + sampleParam, paramVal, &channelMute[n])) return;
-        if(changeValueTreeParam(changedParam, "SOLO" + sampleParam, paramVal, &channelSolo[n])) return;
+    switch (target.field)
+    {
+        case paramMasterVolume:
+            masterVol = (float) (std::pow(paramVal.operator float(), 2) /std::pow(64, 2));
+            break;
 
-        if(changeValueTreeParam(changedParam, (paulaStereo[n] ? "CHANNEL WIDTH" : "CHANNEL PAN") + sampleParam, paramVal, &channelPan[n])) return;
-        
-        if(juce::StringArray("ATTACK"  + sampleParam, "DECAY"  + sampleParam, "SUSTAIN"  + sampleParam, "RELEASE"  + sampleParam).contains(changedParam))
+        case paramMasterPan:
         {
-            AmiSamplerSound* sound = dynamic_cast<AmiSamplerSound*>(sampler[n].getSound(0).get());
-            
-            if(sound == nullptr) return;
+            const float pan = paramVal.operator float();
 
-            if(changeValueTreeParam(changedParam, "ATTACK"  + sampleParam, paramVal, &adsrParams.attack))
-            {
-                sound->setEnvelopeAttack(adsrParams.attack);
-                return;
-            } 
-            
-            if(changeValueTreeParam(changedParam, "DECAY"  + sampleParam, paramVal, &adsrParams.decay))
-            {
-                sound->setEnvelopeDecay(adsrParams.decay);
-                return;
-            } 
-            
-            if(changeValueTreeParam(changedParam, "SUSTAIN"  + sampleParam, paramVal, &adsrParams.sustain))
-            {
-                sound->setEnvelopeSustain(adsrParams.sustain);
-                return;
-            } 
-            
-            if(changeValueTreeParam(changedParam, "RELEASE"  + sampleParam, paramVal, &adsrParams.release))
-            {
-                sound->setEnvelopeRelease(adsrParams.release);
-                return;
-            } 
+            masterPanL = pan <= 128 ? 1.f : std::abs(pan - 255) / 127;
+            masterPanR = pan >= 128 ? 1.f : pan / 127;
+            break;
         }
-    }
-}
 
-bool AmiAudioProcessor::changeValueTreeParam(const juce::String &param, const juce::String &paramToCheck, const juce::var &paramVal, int *paramVar)
-{
-    if(param.compare(paramToCheck)) return false;
+        case paramLedFilter:        ledFilterOn = paramVal.operator int(); break;
+        case paramModelType:        isA500 = paramVal.operator int(); break;
+        case paramPolyphony:        voicePool.setPolyphonyLimit(paramVal.operator int()); break;
+        case paramVibratoSpeed:     vibeSpeed = paramVal.operator double(); break;
+        case paramVibratoIntensity: modIntensity = paramVal.operator int(); break;
 
-    jassert(paramVar != nullptr);
-    *paramVar = paramVal.operator int();
+        case paramChannelVolume:
+            channelVolume[n] = (float) (std::pow(paramVal.operator float(), 2)/std::pow(64, 2));
+            break;
 
-    return true;
-}
+        case paramMidiChannel:
+            sampleMidiChannel[n] = paramVal.operator int();
+            midiDispatcher.invalidateRouting();
+            break;
 
-bool AmiAudioProcessor::changeValueTreeParam(const juce::String &param, const juce::String &paramToCheck, const juce::var &paramVal, std::atomic<int> *paramVar)
-{
-    if(param.compare(paramToCheck)) return false;
+        case paramRootNote:
+            midiRootNote[n] = paramVal.operator int();
+            break;
 
-    jassert(paramVar != nullptr);
-    paramVar->store(paramVal.operator int());
+        case paramLowNote:
+            midiLowNote[n] = paramVal.operator int();
+            midiDispatcher.invalidateRouting();
+            break;
 
-    return true;
-}
+        case paramHighNote:
+            midiHiNote[n] = paramVal.operator int();
+            midiDispatcher.invalidateRouting();
+            break;
 
-bool AmiAudioProcessor::changeValueTreeParam(const juce::String &param, const juce::String &paramToCheck, const juce::var &paramVal, float *paramVar)
-{
-    if(param.compare(paramToCheck)) return false;
+        case paramSampleAndHold:
+            snh[n] = paramVal.operator int();
 
-    jassert(paramVar != nullptr);
-    *paramVar = paramVal.operator float();
+            if (AmiSamplerSound* sound = dynamic_cast<AmiSamplerSound*>(sampler[n].getCurrentSound()))
+                sound->setSampleAndHold(snh[n]);
+            break;
 
-    return true;
-}
+        case paramLoopEnable: loopEnable[n] = paramVal.operator int(); break;
+        case paramLoopStart:  loopStart[n] = paramVal.operator int(); break;
+        case paramLoopEnd:    loopEnd[n] = paramVal.operator int(); break;
 
-bool AmiAudioProcessor::changeValueTreeParam(const juce::String &param, const juce::String &paramToCheck, const juce::var &paramVal, std::atomic<float> *paramVar)
-{
-    if(param.compare(paramToCheck)) return false;
+        case paramMonoPoly:
+            numVoices[n] = paramVal.operator int();
+            setNumVoices(n);
+            break;
 
-    jassert(paramVar != nullptr);
-    paramVar->store(paramVal.operator float());
+        case paramPaulaStereo:
+            paulaStereo[n] = paramVal.operator int();
+            channelPan[n].store(APVTS.getRawParameterValue((paulaStereo[n] ? "CHANNEL WIDTH" : "CHANNEL PAN") + juce::String(n))->load());
+            break;
 
-    return true;
-}
+        case paramChannelGliss: channelGliss[n] = paramVal.operator float(); break;
+        case paramFineTune:     tune[n] = paramVal.operator float(); break;
+        case paramMute:         channelMute[n] = paramVal.operator int(); break;
+        case paramSolo:         channelSolo[n] = paramVal.operator int(); break;
 
-bool AmiAudioProcessor::changeValueTreeParam(const juce::String &param, const juce::String &paramToCheck, const juce::var &paramVal, std::atomic<double> *paramVar)
-{
-    if(param.compare(paramToCheck)) return false;
+        // pan and width share one value; only the one in use for the current mode applies
+        case paramChannelPan:
+        case paramChannelWidth:
+            if ((target.field == paramChannelWidth) == (paulaStereo[n] != 0))
+                channelPan[n] = paramVal.operator float();
+            break;
 
-    jassert(paramVar != nullptr);
-    paramVar->store(paramVal.operator double());
+        case paramAttack:
+        case paramDecay:
+        case paramSustain:
+        case paramRelease:
+        {
+            AmiSamplerSound* sound = dynamic_cast<AmiSamplerSound*>(sampler[n].getCurrentSound());
 
-    return true;
-}
+            if (sound == nullptr) break;
 
-bool AmiAudioProcessor::changeValueTreeParam(const juce::String &param, const juce::String &paramToCheck, const juce::var &paramVal, double *paramVar)
-{
-    if(param.compare(paramToCheck)) return false;
+            const float value = paramVal.operator float();
 
-    jassert(paramVar != nullptr);
-    *paramVar = paramVal.operator double();
+            if (target.field == paramAttack)  sound->setEnvelopeAttack((adsrParams.attack = value));
+            if (target.field == paramDecay)   sound->setEnvelopeDecay((adsrParams.decay = value));
+            if (target.field == paramSustain) sound->setEnvelopeSustain((adsrParams.sustain = value));
+            if (target.field == paramRelease) sound->setEnvelopeRelease((adsrParams.release = value));
+            break;
+        }
 
-    return true;
+        case paramInterpolation:
+            interpolation[n] = juce::jlimit(0, AmiVoiceBank::numInterpolationModes - 1, paramVal.operator int());
+            break;
+
+        case paramDiskStream:
+        {
+            const int stream = paramVal.operator int();
+            const juce::String path = APVTS.state.getProperty("pathname" + juce::String(n)).toString();
+
+            // a restored state already loaded the slot in the right mode
+            if (diskStream[n].exchange(stream) != stream && !init && path.isNotEmpty() && getSampleLength(n) > 0)
+                sampleLoader.loadAsync(n, juce::File(path), true);
+            break;
+        }
+
+        default:
+            break;
+    }
 }
 
 //==============================================================================
@@ -9,17 +9,30 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <unordered_map>
 #include "RCFilters.h"
+#include "AmiSynthesiser.h"
+#include "AmiMidiDispatcher.h"
+#include "AmiParameterQueue.h"
+#include "AmiSampleReclaimer.h"
+#include "AmiSampleLoader.h"
+#include "AmiSampleStore.h"
+#include "AmiSampleBuffer.h"
+#include "AmiResampler.h"
+#include "AmiDiskStreamer.h"
 
 //==============================================================================
 /**
 */
 
 constexpr int NUM_SAMPLERS = 12;
+static_assert(NUM_SAMPLERS <= AmiVoicePool::maxSlots, "every sampler needs a slot in the voice pool");
+static_assert(NUM_SAMPLERS <= AmiMidiDispatcher::maxSlots, "every sampler needs a bit in the MIDI routing table");
+static_assert(NUM_SAMPLERS <= AmiSampleStore::maxSlots, "every sampler needs a slot in the sample store");
 
 class AmiAudioProcessor : public juce::AudioProcessor,
-                          public juce::MidiMessageCollector,
-                          public juce::ValueTree::Listener
+                          public juce::ValueTree::Listener,
+                          private juce::Timer
 {
 public:
     //==============================================================================
@@ -60,19 +73,26 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    void handleNoteOn(juce::MidiKeyboardState* source, int midiChannel, int midiNoteNumber, float velocity) override;
-    void handleNoteOff(juce::MidiKeyboardState* source, int midiChannel, int midiNoteNumber, float velocity) override;
-
     bool saveFile(juce::File& file);
     void saveFileButton(const juce::String& name, std::function<void (const juce::FileChooser&)>& callback);
     void buttonLoadFile(std::function<void (const juce::FileChooser&)>&);
     bool loadFile(const juce::String& path);
-    void resampleAudioData(const int, const double);
 
-    inline juce::AudioBuffer<float>& getWaveForm(const int i) { return waveForm[i]; }
+    /** Message thread: takes over a decoded file from the sample loader. */
+    void applyLoadedSample(AmiSampleLoader::LoadResult_t& result);
+    AmiSampleLoader& getSampleLoader() { return sampleLoader; }
+    void resampleAudioData(const int, const double, const AmiResampler::Quality = AmiResampler::qualityHigh);
+
+    inline const juce::AudioBuffer<float>& getWaveForm(const int i) const { return AmiSampleBuffer::getBufferOf(waveForm[i].get()); }
+    inline AmiSampleBuffer::Ptr getSampleBuffer(const int i) const { return waveForm[i]; }
+
+    /** The slot's length in samples, which for a streamed slot is more than its waveform holds. */
+    inline int getSampleLength(const int i) const { return waveForm[i] != nullptr ? waveForm[i]->getLength() : 0; }
+
+    /** Replaces a slot's samples (nullptr empties it); the next save encodes them again. */
+    void setWaveForm(const int i, AmiSampleBuffer::Ptr samples);
 
     juce::MidiKeyboardState& getKeyState() { return keyState; }
-    juce::MidiMessageCollector& getMidiCollector() { return midiCollector; }
 
     inline void setCurrentSample(const int i) { currentSample = i; }
     inline int& getCurrentSample() { return currentSample; }
@@ -81,7 +101,12 @@ public:
     void setSampleName(const int i, const juce::String name) { sampleName[i] = name; }
     void setSamplerEnvelopes(const int i, void* sound);
 
-    inline juce::Synthesiser& getSampler(const int i) { return sampler[i]; }
+    inline AmiSynthesiser& getSampler(const int i) { return sampler[i]; }
+
+    /** Publishes a fully built sound for a slot (or clears it with nullptr). The
+        old sound is released in the background once nothing is playing it.
+    */
+    void setSampleSound(const int i, juce::SynthesiserSound* sound);
 
     inline void setAVPTSvalue(const juce::String& param, const juce::var val)
     {
@@ -225,9 +250,19 @@ public:
     inline std::atomic<double>& getDevSampleRate() { return devSampleRate; }
 
     std::atomic<int>&   getSnH(const int i) { return snh[i]; }
+    std::atomic<int>&   getInterpolation(const int i) { return interpolation[i]; }
+    std::atomic<int>&   getDiskStream(const int i) { return diskStream[i]; }
+
+    AmiDiskStreamer& getDiskStreamer() { return diskStreamer; }
+
+    /** Samples streamed voices have had to play as silence because the disk fell
+        behind, since the plugin was created. Updated on the message thread's timer.
+    */
+    int getStreamUnderruns() const { return streamUnderruns; }
 
     std::atomic<float>& getFineTune(const int i) { return tune[i]; }
-    std::atomic<float>& getVibrato() { return vibeRatio; }
+    /** Per-sample vibrato ratio for the block being rendered, shared by every voice. */
+    inline const float* getVibratoBuffer() const { return vibratoBuffer.getReadPointer(0); }
     std::atomic<float>& getGlissando(const int i) { return channelGliss[i]; }
 
     std::atomic<float>& getChanVol(const int i) { return channelVolume[i]; }
@@ -269,10 +304,32 @@ public:
 
 private:
 
-    void initFilters();
-    void getAmiFilter(const float *inL, const float* inR, float *outL, float *outR);
     void setNumVoices(const int i);
-    void incVibratoTable();
+    void renderVibrato(const int numSamples);
+    void renderVibratoSegment(float* vibrato, const int numSamples);
+    void timerCallback() override;
+
+    typedef struct RestoredSlot_t
+    {
+    public:
+
+        juce::String name, path;
+
+        AmiStateFormat::SampleChunk_t chunk;        // binary states
+        juce::String waveformData;                  // legacy XML states, base64
+
+        AmiSampleBuffer::Ptr samples;
+        juce::SynthesiserSound::Ptr sound;
+
+        AmiSampleLoader::LoadResult_t fromFile;     // v0.6 states, which only kept the path
+
+    } RestoredSlot_t;
+
+    /** The slot's samples in full, read back from disk into scratch for a streamed slot. */
+    const juce::AudioBuffer<float>& getFullWaveForm(const int i, juce::AudioBuffer<float>& scratch);
+
+    /** Worker thread: decodes and quantizes one slot of a state being restored. */
+    void restoreSlot(RestoredSlot_t& slot, const int i, const bool binaryState);
 
     const uint8_t vibratoTable[32] =
     {
@@ -285,9 +342,18 @@ private:
     float scaleFactor = 0.75f;
     int baseOctave = 5;
 
-    juce::Synthesiser sampler[NUM_SAMPLERS];
+    AmiDiskStreamer diskStreamer;
+    AmiVoicePool voicePool;
+    AmiSynthesiser sampler[NUM_SAMPLERS];
+    AmiMidiDispatcher midiDispatcher;
+
+    std::atomic<uint32_t> renderEpoch { 0 };
+    AmiSampleReclaimer sampleReclaimer { renderEpoch };
+
+    AmiParameterQueue parameterFeedback;
+    juce::RangedAudioParameter* vibratoIntensityParam = nullptr;
     juce::String sampleName[NUM_SAMPLERS];
-    juce::AudioBuffer<float> waveForm[NUM_SAMPLERS];
+    AmiSampleBuffer::Ptr waveForm[NUM_SAMPLERS];
 
     std::unique_ptr<juce::FileChooser> myChooser = nullptr;
     juce::String lastFileDir;
@@ -296,41 +362,68 @@ private:
     juce::ADSR::Parameters adsrParams;
 
     RCFilter rcFilter;
-    RCFilter::OnePoleFilter_t a500FilterLo, a500FilterHi, a1200FilterHi;
-    RCFilter::TwoPoleFilter_t filterLED;
 
-    int currentSample = 0, modIntensity = 0, panCounter[NUM_SAMPLERS];
+    int currentSample = 0, panCounter[NUM_SAMPLERS];
+    std::atomic<int> modIntensity = 0;
     int numVoices[NUM_SAMPLERS];
     juce::BigInteger voiceRange;
 
-    juce::MidiMessageCollector midiCollector;
-    juce::MidiBuffer midiBuffer;
     juce::MidiKeyboardState keyState;
     juce::AudioFormatManager formatManager;
 
     juce::AudioProcessorValueTreeState APVTS;
     std::unique_ptr<juce::AudioProcessorValueTreeState::Listener> listener;
 
+    AmiSampleLoader sampleLoader { *this, formatManager };
+    AmiSampleStore sampleStore;
+
     std::unique_ptr<juce::AudioParameterInt>   createParam(const juce::String&, const int, const int, const int);
     std::unique_ptr<juce::AudioParameterFloat> createParam(const juce::String&, const float&, const float&, const float&, const float);
     juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
     void valueTreePropertyChanged(juce::ValueTree& treeWhosePropertyHasChanged,
                                 const juce::Identifier& property) override;
-    
-    bool changeValueTreeParam(const juce::String&, const juce::String&, const juce::var&, int*);
-    bool changeValueTreeParam(const juce::String&, const juce::String&, const juce::var&, std::atomic<int>*);
-    bool changeValueTreeParam(const juce::String&, const juce::String&, const juce::var&, float*);
-    bool changeValueTreeParam(const juce::String&, const juce::String&, const juce::var&, std::atomic<float>*);
-    bool changeValueTreeParam(const juce::String&, const juce::String&, const juce::var&, double*);
-    bool changeValueTreeParam(const juce::String&, const juce::String&, const juce::var&, std::atomic<double>*);
+
+    // every parameter ID resolved once to the field (and sampler slot) it sets
+    enum ParamField
+    {
+        paramMasterVolume, paramMasterPan, paramLedFilter, paramModelType, paramPolyphony,
+        paramVibratoSpeed, paramVibratoIntensity,
+
+        firstSampleParam,
+
+        paramChannelVolume = firstSampleParam, paramMidiChannel, paramRootNote, paramLowNote,
+        paramHighNote, paramSampleAndHold, paramLoopEnable, paramLoopStart, paramLoopEnd,
+        paramMonoPoly, paramPaulaStereo, paramChannelGliss, paramFineTune, paramMute, paramSolo,
+        paramChannelPan, paramChannelWidth, paramAttack, paramDecay, paramSustain, paramRelease,
+        paramInterpolation, paramDiskStream,
+
+        numParamFields
+    };
+
+    typedef struct ParamTarget_t
+    {
+    public:
+
+        ParamField field;
+        int slot;
+
+    } ParamTarget_t;
+
+    struct ParamIdHash { size_t operator()(const juce::String& id) const noexcept { return (size_t) id.hash(); } };
+
+    std::unordered_map<juce::String, ParamTarget_t, ParamIdHash> paramTargets;
+
+    void buildParamTargets();
+    void applyParam(const ParamTarget_t&, const juce::var&);
 
     bool init = true, hostIsPlaying = false, showExtendedOptions = false, textInHex = true;
 
     double vibeRate = 0.f;
+    juce::AudioBuffer<float> vibratoBuffer;
     std::atomic<double> vibeSpeed = 5.f, devSampleRate = 44100.f;
 
     std::atomic<float> masterVol = 1.f, masterPanL = 1.f, masterPanR = 1.f, 
-                       channelGliss[NUM_SAMPLERS], tune[NUM_SAMPLERS], vibeRatio = 1.f;
+                       channelGliss[NUM_SAMPLERS], tune[NUM_SAMPLERS];
 
     std::atomic<float> channelVolume[NUM_SAMPLERS], channelPan[NUM_SAMPLERS],
                        channelAttack[NUM_SAMPLERS], channelDecay[NUM_SAMPLERS],
@@ -339,6 +432,8 @@ private:
     std::atomic<int> sampleMidiChannel[NUM_SAMPLERS], midiRootNote[NUM_SAMPLERS], midiLowNote[NUM_SAMPLERS], midiHiNote[NUM_SAMPLERS];
 
     std::atomic<int> loopStart[NUM_SAMPLERS], loopEnd[NUM_SAMPLERS], loopEnable[NUM_SAMPLERS], snh[NUM_SAMPLERS], pingpongLoop[NUM_SAMPLERS];
+    std::atomic<int> interpolation[NUM_SAMPLERS], diskStream[NUM_SAMPLERS];
+    int streamUnderruns = 0;
 
     std::atomic<double> sourceSampleRate[NUM_SAMPLERS], resampleRate[NUM_SAMPLERS];
 
@@ -113,3 +113,204 @@ void RCFilter::twoPoleLPFilter(TwoPoleFilter_t *f, const float* inL, const float
 	*outL = (float) LOut;
 	*outR = (float) ROut;
 }
+
+
+/* Block-based Amiga output chain, float lanes for L/R
+*/
+
+void RCFilter::initFilters(double audioRate)
+{
+	OnePoleFilter_t onePole;
+	TwoPoleFilter_t twoPole;
+
+	double  R  = 0., C  = 0.,
+			R1 = 0., R2 = 0.,
+			C1 = 0., C2 = 0.,
+			cutoff  = 0.,
+			qfactor = 0.;
+
+	OnePoleBlockFilter_t* const onePoleFilters[3] = { &a500FilterLo, &a500FilterHi, &a1200FilterHi };
+
+	// A500 1-pole (6dB/oct) RC low-pass filter:
+	R = 360.0; // R321 (360 ohm)
+	C = 1e-7;  // C321 (0.1uF)
+	cutoff = 1.0 / (twoPi * R * C); // ~4420.971Hz
+	setupOnePoleFilter(audioRate, cutoff, &onePole);
+	a500FilterLo.a1 = (float) onePole.a1;
+	a500FilterLo.a2 = (float) onePole.a2;
+
+	// A500 1-pole (6dB/oct) RC high-pass filter:
+	R = 1390.0;   // R324 (1K ohm) + R325 (390 ohm)
+	C = 2.233e-5; // C334 (22uF) + C335 (0.33uF)
+	cutoff = 1.0 / (twoPi * R * C); // ~5.128Hz
+	setupOnePoleFilter(audioRate, cutoff, &onePole);
+	a500FilterHi.a1 = (float) onePole.a1;
+	a500FilterHi.a2 = (float) onePole.a2;
+
+	// A1200 1-pole (6dB/oct) RC high-pass filter:
+	R = 1360.0; // R324 (1K ohm resistor) + R325 (360 ohm resistor)
+	C = 2.2e-5; // C334 (22uF capacitor)
+	cutoff = 1.0 / (twoPi * R * C); // ~5.319Hz
+	setupOnePoleFilter(audioRate, cutoff, &onePole);
+	a1200FilterHi.a1 = (float) onePole.a1;
+	a1200FilterHi.a2 = (float) onePole.a2;
+
+	// Amiga LED 2-pole (12dB/oct) RC low-pass filter:
+	R1 = 10000.0; // R322 (10K ohm)
+	R2 = 10000.0; // R323 (10K ohm)
+	C1 = 6.8e-9;  // C322 (6800pF)
+	C2 = 3.9e-9;  // C323 (3900pF)
+	cutoff = 1.0 / (twoPi * std::sqrt(R1 * R2 * C1 * C2)); // ~3090.533Hz
+	qfactor = std::sqrt(R1 * R2 * C1 * C2) / (C2 * (R1 + R2)); // ~0.660225
+	setupTwoPoleFilter(audioRate, cutoff, qfactor, &twoPole);
+	filterLED.a1 = (float) twoPole.a1;
+	filterLED.a2 = (float) twoPole.a2;
+	filterLED.b1 = (float) twoPole.b1;
+	filterLED.b2 = (float) twoPole.b2;
+
+	for (auto* f : onePoleFilters)
+		f->tmp[0] = f->tmp[1] = 0.f;
+
+	for (int i = 0; i < 4; i++)
+		filterLED.tmp[i][0] = filterLED.tmp[i][1] = 0.f;
+}
+
+void RCFilter::setModel(const bool isA500, const bool ledOn)
+{
+	modelA500 = isA500;
+	ledFilterOn = ledOn;
+}
+
+void RCFilter::processBlock(float* L, float* R, int numSamples)
+{
+	jassert(L != nullptr);
+
+	if (R != nullptr)
+	{
+		if (modelA500)
+			ledFilterOn ? processChain<true, true, true>(L, R, numSamples) : processChain<true, false, true>(L, R, numSamples);
+		else
+			ledFilterOn ? processChain<false, true, true>(L, R, numSamples) : processChain<false, false, true>(L, R, numSamples);
+	}
+	else
+	{
+		if (modelA500)
+			ledFilterOn ? processChain<true, true, false>(L, R, numSamples) : processChain<true, false, false>(L, R, numSamples);
+		else
+			ledFilterOn ? processChain<false, true, false>(L, R, numSamples) : processChain<false, false, false>(L, R, numSamples);
+	}
+}
+
+/* L and R side by side in one register: the low two lanes of an SSE register,
+** a NEON float32x2_t, or a plain pair of floats where neither is available.
+*/
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define AMI_RC_PAIR_SSE 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define AMI_RC_PAIR_NEON 1
+#endif
+
+namespace
+{
+#if AMI_RC_PAIR_SSE
+
+	typedef __m128 StereoPair;
+
+	inline StereoPair pairSet(const float l, const float r)          { return _mm_setr_ps(l, r, 0.f, 0.f); }
+	inline StereoPair pairFill(const float v)                        { return _mm_set1_ps(v); }
+	inline StereoPair pairAdd(const StereoPair a, const StereoPair b) { return _mm_add_ps(a, b); }
+	inline StereoPair pairSub(const StereoPair a, const StereoPair b) { return _mm_sub_ps(a, b); }
+	inline StereoPair pairMul(const StereoPair a, const StereoPair b) { return _mm_mul_ps(a, b); }
+	inline float pairLeft(const StereoPair a)                         { return _mm_cvtss_f32(a); }
+	inline float pairRight(const StereoPair a)                        { return _mm_cvtss_f32(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1))); }
+
+#elif AMI_RC_PAIR_NEON
+
+	typedef float32x2_t StereoPair;
+
+	inline StereoPair pairSet(const float l, const float r)          { return vset_lane_f32(r, vdup_n_f32(l), 1); }
+	inline StereoPair pairFill(const float v)                        { return vdup_n_f32(v); }
+	inline StereoPair pairAdd(const StereoPair a, const StereoPair b) { return vadd_f32(a, b); }
+	inline StereoPair pairSub(const StereoPair a, const StereoPair b) { return vsub_f32(a, b); }
+	inline StereoPair pairMul(const StereoPair a, const StereoPair b) { return vmul_f32(a, b); }
+	inline float pairLeft(const StereoPair a)                         { return vget_lane_f32(a, 0); }
+	inline float pairRight(const StereoPair a)                        { return vget_lane_f32(a, 1); }
+
+#else
+
+	typedef struct StereoPair { float l, r; } StereoPair;
+
+	inline StereoPair pairSet(const float l, const float r)          { return { l, r }; }
+	inline StereoPair pairFill(const float v)                        { return { v, v }; }
+	inline StereoPair pairAdd(const StereoPair a, const StereoPair b) { return { a.l + b.l, a.r + b.r }; }
+	inline StereoPair pairSub(const StereoPair a, const StereoPair b) { return { a.l - b.l, a.r - b.r }; }
+	inline StereoPair pairMul(const StereoPair a, const StereoPair b) { return { a.l * b.l, a.r * b.r }; }
+	inline float pairLeft(const StereoPair a)                         { return a.l; }
+	inline float pairRight(const StereoPair a)                        { return a.r; }
+
+#endif
+}
+
+template <bool a500, bool led, bool stereo>
+void RCFilter::processChain(float* L, float* R, int numSamples)
+{
+	OnePoleBlockFilter_t& hp = a500 ? a500FilterHi : a1200FilterHi;
+	OnePoleBlockFilter_t& lp = a500FilterLo;
+	TwoPoleBlockFilter_t& f  = filterLED;
+
+	// the state stays in registers for the whole block; a mono bus runs silence through R
+	StereoPair lpTmp = pairSet(lp.tmp[0], lp.tmp[1]), hpTmp = pairSet(hp.tmp[0], hp.tmp[1]);
+	StereoPair ledTmp[4];
+
+	for (int n = 0; n < 4; n++)
+		ledTmp[n] = pairSet(f.tmp[n][0], f.tmp[n][1]);
+
+	const StereoPair lpA1 = pairFill(lp.a1), lpA2 = pairFill(lp.a2);
+	const StereoPair hpA1 = pairFill(hp.a1), hpA2 = pairFill(hp.a2);
+	const StereoPair ledA1 = pairFill(f.a1), ledA2 = pairFill(f.a2), ledB1 = pairFill(f.b1), ledB2 = pairFill(f.b2);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		StereoPair x = pairSet(L[i], stereo ? R[i] : 0.0f);
+
+		if (a500)
+		{
+			lpTmp = pairAdd(pairMul(x, lpA1), pairMul(lpTmp, lpA2));
+			x = lpTmp;
+		}
+
+		hpTmp = pairAdd(pairMul(x, hpA1), pairMul(hpTmp, hpA2));
+		x = pairSub(x, hpTmp);
+
+		if (led)
+		{
+			const StereoPair out = pairSub(pairSub(pairAdd(pairAdd(pairMul(x, ledA1), pairMul(ledTmp[0], ledA2)),
+			                                                pairMul(ledTmp[1], ledA1)),
+			                                        pairMul(ledTmp[2], ledB1)),
+			                                pairMul(ledTmp[3], ledB2));
+
+			ledTmp[1] = ledTmp[0];
+			ledTmp[0] = x;
+			ledTmp[3] = ledTmp[2];
+			ledTmp[2] = out;
+
+			x = out;
+		}
+
+		L[i] = pairLeft(x);
+		if (stereo) R[i] = pairRight(x);
+	}
+
+	lp.tmp[0] = pairLeft(lpTmp);
+	lp.tmp[1] = pairRight(lpTmp);
+	hp.tmp[0] = pairLeft(hpTmp);
+	hp.tmp[1] = pairRight(hpTmp);
+
+	for (int n = 0; n < 4; n++)
+	{
+		f.tmp[n][0] = pairLeft(ledTmp[n]);
+		f.tmp[n][1] = pairRight(ledTmp[n]);
+	}
+}
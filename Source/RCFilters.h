@@ -57,8 +57,54 @@ public:
 
     void twoPoleLPFilter(TwoPoleFilter_t *f, const float *inL, const float* inR, float *outL, float* outR);
 
+    //==============================================================================
+    /*  Block-based Amiga output chain (A500 LP + HP or A1200 HP, then optional LED).
+
+        L and R are packed side by side in one SSE or NEON register (a plain float
+        pair elsewhere), so each stage is one packed multiply and add per sample
+        for both channels. The model, LED and mono/stereo selection is made once
+        per block instead of per sample.
+
+        Error bounds of the float path against the double per-sample filters above,
+        for a full-scale (|x| <= 1) input: every one-pole stage adds at most ~3 ulp
+        (3 * 2^-24) of rounding per sample, which the recursion accumulates by at
+        most 1 / (1 - a2). The worst stage is the ~5Hz high-pass, giving a bound of
+        roughly 2.5e-4 (-72dBFS) at 44.1kHz, 5.3e-4 (-65dBFS) at 96kHz and 1.1e-3
+        (-59dBFS) at 192kHz. The ~4.4kHz low-pass and ~3.1kHz LED stages stay within a
+        few 1e-6. All of these sit well below one 8-bit Paula step (1/128, -42dBFS).
+    */
+    void initFilters(double audioRate);
+    void setModel(const bool isA500, const bool ledOn);
+
+    /** Filters a block in place. R may be nullptr for a mono bus. */
+    void processBlock(float* L, float* R, int numSamples);
+
 private:
-    
+
+    typedef struct OnePoleBlockFilter_t
+    {
+    public:
+
+        float tmp[2], a1, a2;
+
+    } OnePoleBlockFilter_t;
+
+    typedef struct TwoPoleBlockFilter_t
+    {
+    public:
+
+        float tmp[4][2], a1, a2, b1, b2;
+
+    } TwoPoleBlockFilter_t;
+
+    template <bool a500, bool led, bool stereo>
+    void processChain(float* L, float* R, int numSamples);
+
+    OnePoleBlockFilter_t a500FilterLo, a500FilterHi, a1200FilterHi;
+    TwoPoleBlockFilter_t filterLED;
+
+    bool modelA500 = false, ledFilterOn = false;
+
     const double smallNumber{ 1E-4 };
     const double twoPi = juce::MathConstants<double>::twoPi;
     const double pi = juce::MathConstants<double>::pi;
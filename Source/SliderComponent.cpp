@@ -104,7 +104,7 @@ void SliderComponent::changeSampleChannel(const int &channel)
     const juce::String currentSampleAtch = juce::String((currentSample = channel));
     const juce::String currentSampleLbl = juce::String(currentSample + 1).paddedLeft('0', 2);
 
-    enableGliss(audioProcessor.getSampler(currentSample).getNumVoices() == 1);
+    enableGliss(audioProcessor.getSampler(currentSample).getVoiceLimit() == 1);
 
     changePanWidth(audioProcessor.paulaStereoOn(currentSample), currentSampleAtch, currentSampleLbl);
     attachSlider(&channelVolSlider, &channelVolLabel, "Chan " + currentSampleLbl + "\nVolume", 